@@ -0,0 +1,265 @@
+#pragma once
+
+#include <cstdint>
+
+// Ranks 0..4095 of a 64x64 blue-noise mask, row major. Made with
+// void-and-cluster (Ulichney 1993) on a torus: Gaussian energy with sigma
+// 1.5, relaxed from a fixed pseudo-random tenth of the pixels.
+const uint16_t BLUE_NOISE_RANKS[64 * 64] = {
+  186, 795, 1676, 3343, 1071, 3773, 207, 1561, 2285, 3360, 3858, 906, 3138, 3485, 1567, 2403,
+  3255, 1704, 1024, 293, 794, 3906, 1587, 3092, 2229, 1810, 420, 3054, 991, 3672, 3212, 2488,
+  4081, 1520, 2622, 1243, 1801, 3428, 347, 2759, 3852, 1420, 1688, 2714, 3043, 3774, 2448, 1116,
+  3864, 1470, 926, 3525, 1535, 453, 2891, 1213, 2728, 3458, 719, 4040, 2309, 265, 3158, 2405,
+  1141, 3959, 2163, 2782, 639, 1903, 2585, 3506, 620, 1125, 2495, 1933, 456, 2235, 4031, 953,
+  482, 2810, 1417, 3505, 3136, 1992, 89, 3687, 913, 4013, 1207, 2380, 78, 2676, 1637, 1151,
+  2019, 464, 3291, 2201, 2905, 611, 3098, 1913, 863, 3200, 3593, 659, 1305, 62, 766, 3167,
+  2104, 2974, 1943, 117, 2219, 3308, 2437, 3860, 1744, 2244, 394, 1293, 2649, 1002, 1488, 3423,
+  1885, 3081, 1338, 21, 3657, 3047, 919, 1407, 2904, 329, 1656, 3691, 1400, 2853, 38, 1878,
+  3388, 2142, 3869, 2364, 539, 2587, 1132, 2849, 348, 2705, 1604, 3556, 2039, 771, 3792, 169,
+  3128, 876, 3715, 185, 1063, 1534, 3936, 1202, 2208, 302, 2528, 1877, 2264, 3642, 1726, 2679,
+  299, 680, 3699, 2608, 4073, 949, 1410, 653, 287, 2957, 3738, 3223, 1837, 3617, 2792, 675,
+  2284, 401, 3494, 2503, 1582, 2117, 288, 4055, 1875, 3211, 2651, 728, 3279, 1050, 2468, 3767,
+  1257, 752, 123, 1805, 1315, 3340, 1661, 3510, 2028, 715, 3240, 503, 2923, 1366, 3359, 2280,
+  2779, 1686, 2517, 1904, 3509, 2324, 2629, 33, 3746, 2948, 1136, 435, 2860, 3246, 1034, 4006,
+  1371, 3324, 1701, 1251, 384, 1870, 3040, 2134, 3398, 1044, 1539, 791, 55, 2097, 426, 3800,
+  1538, 2847, 1022, 727, 3886, 1199, 3352, 2404, 796, 3550, 1263, 206, 3911, 2059, 582, 1608,
+  2934, 2557, 3547, 3066, 924, 4061, 220, 2411, 1431, 3802, 2281, 1147, 3983, 1899, 378, 1020,
+  3898, 626, 1345, 4017, 803, 469, 3325, 1780, 739, 1619, 3367, 3984, 1481, 182, 1928, 534,
+  2167, 2481, 977, 3210, 2723, 3615, 25, 3956, 2578, 1890, 2805, 2379, 3963, 3120, 1279, 2583,
+  113, 4043, 2007, 3190, 2342, 452, 2758, 1606, 65, 2042, 2336, 3002, 1765, 2738, 3493, 3172,
+  386, 1081, 2035, 307, 2642, 2148, 658, 3198, 989, 7, 1831, 2730, 247, 2456, 3068, 1477,
+  2062, 3405, 84, 2740, 3108, 2080, 1312, 2802, 3558, 2465, 586, 2072, 896, 2582, 3499, 2832,
+  3679, 73, 3850, 548, 2268, 860, 1625, 1268, 700, 233, 3649, 487, 1088, 1703, 3531, 933,
+  1668, 3333, 1317, 205, 1772, 3632, 708, 3062, 3876, 1032, 3723, 411, 1459, 898, 158, 1349,
+  2240, 3973, 1644, 3727, 1388, 2943, 1714, 3855, 2597, 3087, 3708, 882, 1651, 3538, 679, 3677,
+  472, 2970, 2375, 976, 1617, 259, 3845, 957, 2168, 141, 1267, 3115, 3754, 2277, 1195, 1575,
+  854, 1827, 2925, 1467, 1971, 2878, 3249, 2358, 3495, 3015, 1351, 2079, 2927, 2440, 600, 3025,
+  2659, 2155, 609, 2568, 2933, 1073, 2073, 1374, 2497, 1802, 635, 3303, 2586, 4082, 1952, 3624,
+  2686, 690, 3231, 877, 451, 3400, 1157, 322, 2058, 1240, 574, 3432, 2937, 1065, 2237, 2643,
+  1675, 1138, 1883, 3748, 3462, 2576, 619, 3277, 1523, 3935, 2606, 1822, 296, 670, 3256, 225,
+  3070, 2393, 1097, 3442, 217, 3909, 484, 1057, 2016, 1670, 3859, 832, 3319, 193, 1964, 3744,
+  343, 1119, 3870, 3444, 1513, 3782, 163, 3214, 387, 3481, 2811, 1236, 2192, 673, 3029, 1014,
+  1762, 44, 2382, 2822, 1918, 2271, 3620, 768, 2877, 1519, 2430, 2141, 129, 1390, 4068, 260,
+  3197, 3849, 376, 698, 2216, 1441, 2991, 1917, 352, 2915, 873, 3436, 1368, 2680, 4074, 2151,
+  3583, 405, 3969, 2541, 777, 1370, 2647, 3724, 97, 2475, 374, 2677, 1570, 3999, 1307, 810,
+  2320, 3072, 1846, 871, 429, 2239, 2711, 4026, 824, 1548, 2033, 283, 3570, 1577, 2397, 448,
+  3311, 3693, 1142, 1525, 3942, 109, 2562, 1839, 3924, 3348, 414, 3815, 1760, 3239, 1987, 858,
+  1291, 2118, 2716, 3225, 1078, 48, 4088, 1174, 2322, 3658, 523, 2123, 2999, 1685, 996, 1847,
+  1301, 709, 1596, 1923, 3191, 2206, 1742, 3356, 886, 3116, 1230, 3489, 580, 2191, 2799, 3621,
+  3401, 1377, 51, 2460, 3247, 1006, 1795, 1290, 2308, 3021, 3929, 1019, 3183, 120, 3867, 2797,
+  1380, 2128, 2977, 597, 3142, 998, 1396, 3204, 189, 1055, 2681, 820, 2809, 604, 2498, 3526,
+  2942, 122, 1489, 3614, 1814, 2529, 3415, 743, 2788, 1716, 1124, 3889, 17, 3692, 459, 2935,
+  2319, 3300, 2708, 85, 3586, 1150, 312, 2852, 1544, 4083, 2263, 1840, 1083, 3220, 114, 1620,
+  546, 2888, 4075, 2003, 3563, 2903, 614, 3628, 29, 2635, 530, 1430, 2566, 1864, 1162, 1999,
+  773, 4034, 211, 2489, 3579, 1695, 2772, 625, 2356, 2022, 1634, 3537, 1221, 3879, 303, 1585,
+  2303, 3993, 788, 2352, 458, 2952, 1589, 2049, 157, 3156, 2538, 1566, 2295, 837, 2525, 3469,
+  175, 3821, 1036, 2968, 612, 2361, 3759, 710, 2083, 444, 2741, 234, 3804, 2567, 1937, 990,
+  2111, 2616, 763, 1226, 1564, 191, 2116, 3201, 1605, 929, 3497, 2226, 3810, 568, 3117, 3512,
+  336, 2632, 1777, 920, 2082, 371, 3389, 4025, 1282, 3722, 3003, 37, 2242, 1891, 3123, 1113,
+  567, 1911, 3085, 1250, 3740, 967, 326, 3840, 3484, 952, 446, 3369, 1244, 3110, 1909, 1452,
+  915, 1785, 2152, 1480, 4021, 1855, 3091, 2547, 1255, 3387, 916, 3574, 1498, 748, 3010, 3841,
+  335, 1727, 3636, 481, 2658, 3903, 1072, 2462, 3766, 1896, 3124, 298, 1693, 2717, 908, 2294,
+  1482, 3058, 3463, 1270, 3827, 2428, 825, 1792, 264, 2614, 657, 1474, 3290, 909, 2556, 3709,
+  2770, 3447, 282, 2588, 1962, 3265, 2267, 1194, 2432, 1874, 3998, 2660, 240, 3638, 617, 4004,
+  2645, 361, 3234, 2531, 279, 867, 1427, 2, 3835, 1709, 2932, 2021, 2450, 455, 1245, 3452,
+  2372, 1114, 3064, 2249, 3382, 1842, 2944, 695, 266, 1248, 2786, 751, 1321, 3576, 72, 3890,
+  1099, 2108, 461, 2783, 18, 1491, 2931, 2136, 3152, 1011, 3477, 2427, 4047, 505, 1730, 93,
+  1421, 864, 1699, 3866, 589, 1509, 2748, 627, 3034, 1429, 758, 2069, 1626, 2776, 2175, 1129,
+  2982, 3749, 693, 1216, 3372, 2769, 3568, 2272, 3199, 583, 1145, 137, 3301, 4022, 2689, 1533,
+  3288, 3964, 203, 1472, 847, 350, 1354, 3276, 2053, 3871, 2367, 3422, 2143, 2987, 1843, 2466,
+  3284, 711, 3977, 1641, 3189, 3587, 1128, 432, 3885, 1584, 1980, 215, 1306, 2721, 3206, 2086,
+  3965, 2444, 2912, 1098, 3409, 64, 4044, 1719, 3542, 139, 3207, 3695, 992, 502, 3329, 61,
+  1499, 1926, 2290, 3659, 1672, 2127, 1089, 422, 1916, 2678, 3918, 2311, 1678, 890, 2038, 82,
+  2836, 942, 1898, 2699, 3661, 2349, 4054, 2630, 1583, 525, 1082, 194, 4037, 956, 578, 1579,
+  248, 2697, 1934, 980, 2213, 636, 2605, 3334, 2321, 755, 2795, 3681, 2184, 815, 3562, 1152,
+  644, 3337, 196, 2047, 2368, 2998, 931, 2105, 471, 2765, 2338, 1266, 2972, 3938, 1841, 2351,
+  3532, 856, 424, 2893, 177, 664, 3980, 2960, 1495, 816, 3501, 1340, 355, 2956, 3698, 671,
+  1364, 2169, 3781, 641, 3000, 1669, 1005, 178, 3599, 2862, 3312, 1879, 1521, 2624, 3704, 2871,
+  3471, 1383, 3623, 2518, 187, 3757, 1803, 1350, 96, 3018, 1172, 476, 3096, 1505, 275, 2874,
+  2298, 1632, 1310, 3680, 747, 1385, 3639, 2571, 1130, 3932, 640, 1734, 188, 2493, 735, 1228,
+  2610, 3084, 4076, 1425, 2555, 3286, 1815, 2485, 3770, 164, 2009, 2526, 3264, 1085, 2418, 1745,
+  3107, 254, 3368, 1224, 20, 2027, 3486, 726, 2197, 1265, 2505, 734, 3106, 362, 2000, 1135,
+  2195, 774, 382, 3135, 1211, 2873, 826, 4036, 1950, 3465, 1666, 3844, 1902, 2594, 3928, 1823,
+  396, 3803, 2973, 504, 2648, 1755, 229, 3145, 1543, 1942, 3309, 2227, 3595, 1536, 3171, 3833,
+  252, 1708, 1025, 2025, 3784, 836, 1319, 304, 1039, 3344, 2850, 650, 1835, 3561, 480, 3930,
+  827, 2627, 1639, 2297, 3202, 2590, 1324, 3035, 1790, 3940, 90, 2071, 3818, 1356, 3373, 56,
+  4015, 3004, 1832, 3848, 1530, 2125, 395, 3083, 2564, 662, 2407, 993, 53, 3362, 1252, 779,
+  3281, 2522, 950, 1981, 3837, 3383, 2156, 702, 3742, 74, 927, 2883, 403, 1045, 2767, 561,
+  2091, 3438, 607, 2820, 42, 2381, 3061, 3663, 2255, 1664, 1259, 4093, 31, 2712, 1277, 2266,
+  1932, 3571, 524, 3949, 917, 430, 3820, 2366, 340, 1038, 3392, 2887, 968, 2334, 643, 2552,
+  1674, 1015, 2314, 621, 3366, 2459, 3534, 983, 1471, 308, 3612, 2966, 2198, 588, 2396, 3596,
+  2043, 1479, 9, 3126, 1184, 351, 2773, 1308, 2377, 3475, 2628, 1402, 4057, 2154, 1794, 3641,
+  1395, 2978, 2306, 1156, 3523, 1527, 1941, 596, 2720, 399, 3129, 894, 2109, 1522, 3414, 337,
+  3154, 1087, 1462, 2803, 1862, 3377, 1558, 655, 3671, 2641, 1573, 507, 1715, 3178, 3714, 1448,
+  2824, 3295, 159, 2701, 1077, 249, 1720, 2056, 3921, 2793, 1275, 1738, 4094, 1458, 2854, 209,
+  1069, 2814, 4027, 2385, 1653, 875, 3968, 3041, 1718, 526, 2030, 3118, 770, 3394, 98, 2401,
+  930, 204, 3751, 1848, 3180, 367, 3842, 1204, 3439, 2024, 3736, 2451, 3001, 3832, 940, 2777,
+  4042, 79, 2099, 3655, 238, 1144, 2896, 1908, 3121, 1304, 2254, 4058, 2581, 166, 1982, 865,
+  373, 3602, 2011, 3926, 1415, 2919, 3765, 573, 3215, 2279, 793, 218, 3176, 934, 1876, 3756,
+  3165, 646, 1807, 400, 3245, 2554, 1930, 165, 982, 3856, 1182, 316, 1636, 2510, 1289, 3236,
+  4001, 2693, 1454, 474, 2543, 988, 2892, 2360, 845, 1440, 181, 1712, 687, 258, 2409, 1700,
+  603, 2325, 3048, 738, 2620, 2225, 4005, 58, 887, 3521, 301, 807, 3598, 1168, 3038, 3861,
+  2214, 1192, 688, 1756, 3431, 804, 2619, 1175, 67, 1861, 3459, 2625, 2075, 3529, 357, 2536,
+  1274, 2270, 3419, 1387, 3790, 547, 1264, 3589, 2494, 3195, 2230, 3520, 2816, 3884, 418, 1753,
+  633, 2017, 3375, 781, 3961, 2076, 1595, 295, 3910, 2813, 3353, 1140, 3622, 1996, 3252, 1177,
+  2691, 3716, 1229, 1607, 3266, 529, 1409, 2537, 2055, 2851, 1800, 3299, 2103, 1529, 608, 2615,
+  1601, 3192, 2504, 3049, 106, 2330, 1578, 3662, 3013, 1404, 3888, 501, 1158, 2995, 677, 1658,
+  3927, 173, 2665, 831, 2131, 2876, 3342, 2064, 730, 1453, 54, 1818, 651, 1080, 2962, 2258,
+  3099, 1176, 2425, 1680, 3019, 87, 3646, 3131, 1817, 517, 2122, 2551, 2879, 1432, 416, 3519,
+  844, 1854, 280, 3939, 1967, 3590, 1041, 3188, 3778, 594, 1220, 2477, 223, 2796, 3416, 24,
+  986, 4077, 349, 1330, 2094, 3971, 441, 1986, 668, 2754, 962, 2429, 1569, 3776, 2675, 2204,
+  922, 1978, 3656, 3069, 70, 1052, 1580, 390, 3989, 2918, 2602, 3807, 2363, 1565, 3607, 959,
+  28, 3823, 338, 3549, 1094, 2696, 1311, 689, 2482, 1012, 3747, 52, 775, 3992, 2189, 1581,
+  2930, 3403, 2506, 965, 2785, 161, 2329, 1713, 272, 1554, 3960, 3147, 935, 3901, 1764, 2276,
+  3564, 1910, 2825, 630, 3545, 1009, 3130, 2480, 3488, 1771, 263, 3306, 1929, 36, 1342, 3113,
+  3470, 553, 1197, 1761, 4071, 2416, 2727, 3480, 1833, 1031, 490, 1234, 3320, 261, 1969, 2673,
+  3313, 1397, 2844, 1966, 521, 2293, 3473, 1983, 4008, 1492, 2994, 1767, 1287, 3125, 2492, 124,
+  1994, 1333, 460, 3173, 1460, 678, 2911, 3407, 787, 2722, 2250, 391, 1955, 1286, 713, 2958,
+  1398, 842, 2374, 3267, 1809, 2694, 1438, 145, 1153, 4056, 2165, 2945, 3629, 841, 4018, 334,
+  1551, 2900, 2579, 364, 1413, 3232, 879, 214, 2328, 3122, 3670, 2129, 2774, 850, 3955, 542,
+  1711, 2172, 706, 4053, 1560, 3250, 928, 232, 2771, 393, 3322, 2343, 3645, 592, 1091, 3762,
+  665, 3908, 2288, 1758, 3713, 2110, 4069, 1253, 1963, 3669, 1064, 3511, 3024, 2454, 3732, 468,
+  3349, 140, 3812, 1506, 237, 776, 3872, 2269, 3177, 720, 1424, 465, 1123, 2726, 2015, 2400,
+  1029, 3788, 2139, 3358, 1931, 555, 2112, 3891, 1433, 704, 1728, 119, 1414, 3078, 2431, 1205,
+  3745, 2595, 1008, 3101, 125, 2572, 1740, 3701, 2211, 1183, 822, 1954, 246, 2704, 1698, 3219,
+  2812, 923, 3472, 32, 2563, 1100, 320, 2476, 3075, 77, 1824, 660, 1511, 153, 2088, 2598,
+  1677, 2746, 1054, 2178, 3637, 2953, 1925, 492, 1696, 2828, 3569, 2546, 1750, 3213, 610, 3371,
+  1735, 101, 759, 3904, 1090, 3016, 3600, 1137, 2790, 3412, 2412, 4089, 602, 3507, 1631, 360,
+  3033, 179, 3540, 2388, 1196, 3813, 606, 1382, 3023, 3541, 2633, 3900, 1461, 3437, 2166, 197,
+  2439, 1646, 1219, 3009, 761, 3327, 1667, 591, 3829, 1423, 2889, 2549, 3976, 3258, 893, 1212,
+  3878, 2014, 3133, 388, 2457, 1218, 3406, 2600, 3739, 995, 235, 2252, 3934, 155, 1386, 3720,
+  2656, 3086, 1346, 2521, 271, 2310, 1615, 0, 1938, 406, 1000, 2902, 1921, 2282, 925, 3338,
+  1993, 1323, 1769, 559, 2067, 2842, 3395, 1895, 92, 686, 1663, 434, 2946, 904, 3985, 1353,
+  3682, 385, 2159, 3990, 1924, 2807, 3603, 2066, 958, 2339, 3476, 1165, 445, 1791, 2834, 3515,
+  290, 731, 1411, 3991, 616, 1640, 932, 26, 1358, 2040, 3420, 1545, 765, 2984, 2085, 918,
+  409, 2202, 3450, 1799, 2886, 805, 3287, 2584, 3809, 3112, 1516, 3575, 1239, 160, 3933, 2655,
+  691, 2861, 3966, 3262, 1549, 276, 852, 2419, 4090, 2078, 3275, 2469, 1235, 2001, 493, 3077,
+  1845, 3307, 2636, 569, 1468, 210, 1203, 2671, 3146, 284, 764, 2147, 3711, 2370, 595, 1603,
+  2233, 3434, 2867, 1836, 3528, 2817, 3209, 3946, 2402, 3037, 442, 2781, 1191, 3631, 2508, 1630,
+  3997, 1167, 581, 3705, 1494, 4045, 488, 1296, 2221, 642, 2683, 330, 2501, 3149, 1721, 1160,
+  3697, 2149, 375, 902, 2682, 3882, 3097, 1127, 2780, 1363, 870, 3836, 16, 3317, 2621, 740,
+  1111, 108, 3793, 969, 3230, 2327, 3880, 466, 1610, 4033, 1880, 2969, 1, 1337, 3181, 4078,
+  1028, 2520, 69, 889, 2251, 270, 2018, 566, 1684, 789, 3795, 1798, 2313, 515, 3357, 11,
+  2718, 3026, 1960, 133, 1033, 2668, 1866, 3430, 963, 1754, 3915, 2119, 846, 3666, 518, 2406,
+  15, 1501, 2532, 3610, 1272, 2212, 1784, 498, 3605, 262, 2990, 2193, 1741, 3700, 1412, 2305,
+  3032, 1541, 2048, 2866, 1743, 3496, 808, 1979, 3321, 1062, 2631, 1450, 3379, 941, 2565, 216,
+  1959, 3071, 1331, 3796, 2650, 1497, 1117, 3504, 2667, 1227, 3174, 174, 4063, 1007, 1907, 1343,
+  3566, 786, 2422, 3323, 2132, 3114, 294, 2392, 3685, 110, 3263, 1318, 2826, 1537, 2050, 2920,
+  3384, 1066, 3140, 1887, 676, 184, 3350, 1510, 2341, 1873, 3468, 613, 1046, 2833, 251, 4064,
+  3446, 683, 2470, 417, 1171, 47, 2959, 1376, 2446, 170, 3665, 494, 3875, 2100, 2909, 1487,
+  3769, 535, 1746, 3217, 370, 4046, 3119, 2283, 118, 3635, 2093, 2527, 1504, 2846, 3221, 2187,
+  457, 1660, 3937, 1406, 661, 3618, 1628, 744, 2908, 1133, 1914, 545, 3418, 241, 3863, 760,
+  1844, 4065, 306, 2348, 2947, 3734, 2599, 785, 3944, 1093, 2539, 1552, 3196, 2347, 883, 2026,
+  2742, 1284, 3729, 3057, 4023, 2623, 2180, 3817, 654, 3055, 1662, 2312, 717, 1813, 389, 3297,
+  829, 2344, 3660, 1067, 2120, 623, 1838, 936, 2922, 1419, 557, 888, 3441, 313, 736, 3828,
+  2617, 1010, 2941, 277, 2753, 1149, 2542, 3970, 1531, 2243, 2719, 4038, 2387, 1096, 3169, 1384,
+  2707, 563, 1659, 3552, 1408, 1040, 2044, 3144, 128, 2869, 475, 3868, 311, 3582, 1638, 513,
+  1849, 142, 2245, 848, 1906, 1444, 314, 1017, 3410, 2010, 1222, 3282, 2768, 1103, 3584, 2164,
+  1298, 2662, 136, 2857, 1439, 2534, 3688, 419, 3923, 1886, 2798, 3726, 1710, 2340, 1198, 3063,
+  195, 1865, 3425, 2181, 3794, 1912, 39, 3314, 489, 3182, 286, 862, 1643, 2008, 2545, 152,
+  3445, 2248, 859, 2763, 66, 3996, 543, 1447, 1812, 3626, 1344, 1927, 2670, 1164, 3012, 3897,
+  951, 3268, 1611, 3553, 527, 3160, 3611, 1776, 2739, 398, 2591, 115, 4030, 1599, 3059, 226,
+  3958, 1884, 3380, 792, 3543, 3028, 1180, 1645, 2445, 3163, 208, 1126, 2609, 3947, 2051, 1563,
+  3654, 2390, 1278, 496, 939, 3005, 1379, 2135, 1004, 3585, 1336, 3022, 3753, 585, 3619, 1018,
+  1922, 3806, 1292, 3271, 1828, 2299, 2894, 3413, 2443, 899, 2275, 3354, 783, 2176, 224, 2434,
+  3703, 2880, 319, 2515, 1084, 2318, 2859, 749, 3987, 1486, 3457, 985, 2070, 536, 2479, 911,
+  2791, 560, 1571, 2253, 339, 1957, 8, 3339, 745, 1302, 2157, 3289, 669, 50, 3363, 549,
+  2687, 801, 4050, 1682, 3364, 2350, 590, 3877, 2661, 1705, 2424, 2061, 63, 2747, 1518, 3065,
+  368, 2929, 2491, 413, 3487, 798, 1200, 268, 3892, 514, 3089, 102, 4011, 1547, 3492, 1303,
+  647, 2092, 1361, 3408, 3917, 1647, 83, 1294, 2138, 2442, 618, 3676, 2917, 1367, 3824, 1691,
+  3503, 1185, 3148, 3743, 1079, 3995, 2760, 2190, 3597, 454, 4049, 1600, 2848, 1945, 1021, 2971,
+  1451, 135, 3157, 2736, 255, 3707, 1588, 3088, 162, 685, 3801, 1143, 3443, 835, 2316, 3912,
+  1694, 712, 1095, 2113, 1524, 3785, 2544, 2020, 1591, 2752, 1249, 1783, 2800, 467, 3150, 1915,
+  30, 4041, 2766, 769, 415, 2036, 3304, 3725, 324, 3137, 1789, 1179, 2371, 331, 3298, 2222,
+  86, 1972, 2613, 436, 2449, 1737, 878, 1466, 2897, 1936, 2509, 851, 3797, 1326, 3533, 2170,
+  3894, 1816, 2265, 1048, 2037, 772, 2514, 1189, 1989, 3253, 2827, 449, 1796, 3203, 1254, 172,
+  2173, 3162, 4039, 2733, 147, 3017, 622, 3224, 984, 3577, 2137, 3760, 1047, 2389, 834, 2653,
+  3216, 1037, 1778, 2247, 2981, 1434, 2574, 1053, 2775, 813, 3814, 57, 3193, 1892, 753, 1134,
+  2855, 4084, 821, 1437, 3467, 3104, 520, 3816, 154, 1061, 3095, 269, 2231, 499, 2550, 317,
+  892, 3318, 571, 3819, 1325, 2882, 3536, 421, 3941, 880, 1483, 2238, 4095, 2580, 601, 2804,
+  3592, 1357, 470, 1853, 3559, 1260, 1797, 4009, 6, 2484, 692, 230, 3294, 1990, 3839, 1623,
+  3551, 2413, 369, 3355, 970, 3851, 598, 1868, 3548, 1347, 2046, 2715, 1493, 3594, 2548, 3780,
+  379, 1618, 3031, 2114, 132, 1242, 2234, 2634, 3378, 1775, 3689, 1473, 3451, 2914, 1609, 3683,
+  1273, 2789, 2464, 1624, 3105, 146, 2200, 1731, 2750, 2384, 3648, 310, 972, 1443, 3763, 1905,
+  817, 2535, 3361, 914, 2378, 344, 2784, 2207, 1401, 3053, 3479, 1679, 1362, 2985, 315, 1271,
+  701, 3008, 1478, 3684, 100, 2369, 3168, 228, 2289, 3073, 438, 4051, 981, 577, 2976, 1392,
+  2291, 3429, 564, 3706, 2690, 3951, 1820, 757, 1332, 2345, 632, 2577, 1027, 1889, 741, 3134,
+  2023, 35, 3608, 447, 1944, 4014, 946, 3435, 1316, 5, 1863, 3399, 3007, 2045, 267, 3448,
+  1627, 34, 2087, 2951, 1576, 3830, 812, 3404, 497, 1919, 966, 2257, 4085, 572, 2735, 2199,
+  156, 3978, 1977, 1181, 2840, 1725, 1261, 3948, 1597, 694, 2558, 1739, 3386, 2146, 180, 1851,
+  903, 2524, 1169, 1888, 869, 402, 3166, 3588, 342, 3011, 3847, 94, 3248, 3913, 242, 2373,
+  4066, 1540, 1023, 3285, 718, 2417, 1514, 511, 3151, 767, 2845, 1206, 532, 2355, 3184, 1178,
+  2901, 3972, 1110, 3606, 648, 3132, 1752, 1107, 2592, 3907, 2815, 291, 2467, 1121, 3718, 1751,
+  2523, 874, 2710, 437, 2160, 3513, 861, 2700, 3421, 1109, 3664, 243, 2423, 1262, 3931, 3094,
+  3653, 14, 2787, 3326, 1542, 2433, 1076, 2744, 1616, 2096, 907, 1748, 2188, 1327, 2639, 1105,
+  634, 2926, 2218, 2672, 1246, 3675, 2961, 2589, 3771, 2140, 3981, 2471, 1650, 3896, 868, 2611,
+  587, 2300, 327, 1418, 2519, 111, 2274, 3643, 192, 1593, 723, 3604, 1867, 3187, 784, 3449,
+  1297, 1657, 3251, 3717, 684, 2980, 404, 1968, 4, 2133, 2837, 1416, 3222, 857, 2698, 544,
+  1555, 2081, 4020, 300, 2996, 3808, 2158, 75, 4062, 1237, 3385, 2801, 531, 3067, 3554, 1974,
+  3346, 200, 1806, 3887, 333, 2032, 103, 1051, 1782, 1399, 231, 945, 3454, 99, 1502, 2002,
+  3783, 1724, 3283, 2778, 1991, 4019, 1322, 2906, 2068, 3237, 1241, 2993, 1445, 43, 2095, 2916,
+  3834, 222, 2304, 1102, 1532, 4007, 2500, 1352, 3079, 3791, 818, 1893, 479, 3690, 1722, 2337,
+  3478, 1258, 799, 2323, 1341, 554, 1804, 3491, 696, 2559, 354, 3673, 1568, 872, 346, 1665,
+  3789, 1426, 3045, 866, 3517, 1649, 3336, 2326, 407, 3578, 3260, 2757, 1829, 3014, 3601, 397,
+  2950, 1295, 778, 3731, 383, 974, 3330, 509, 885, 3838, 2317, 533, 2644, 3962, 1594, 510,
+  2472, 3427, 1939, 3044, 121, 2126, 960, 3351, 1642, 538, 2447, 3988, 2938, 2205, 104, 1001,
+  2924, 423, 3175, 1872, 3640, 948, 2858, 1449, 3208, 1857, 2210, 1148, 2463, 4002, 2875, 2278,
+  790, 2612, 506, 2395, 1348, 2865, 733, 4086, 3027, 2074, 576, 1313, 2236, 737, 2421, 1016,
+  3411, 76, 2359, 1825, 3052, 1574, 2473, 1900, 2732, 1681, 227, 3466, 921, 2224, 3280, 1074,
+  1786, 565, 849, 3779, 2596, 1723, 3650, 328, 2731, 1201, 3391, 199, 1572, 1217, 3259, 3957,
+  2507, 1484, 3857, 2604, 130, 3293, 2474, 281, 1013, 2910, 3902, 3, 3242, 2029, 1288, 150,
+  3159, 1159, 4012, 3270, 2063, 462, 2570, 1166, 1559, 900, 2540, 3712, 274, 3943, 1436, 2745,
+  2106, 4060, 2664, 1058, 3557, 656, 3883, 60, 3565, 1163, 3103, 2004, 1334, 3652, 285, 2729,
+  1309, 4072, 2829, 1231, 483, 3153, 729, 2332, 3874, 1826, 2183, 943, 3522, 2569, 722, 1856,
+  318, 2130, 629, 1122, 1557, 1948, 3979, 2259, 3696, 516, 1517, 806, 1788, 540, 3456, 2499,
+  3694, 1958, 1613, 23, 1070, 3822, 1773, 3527, 126, 2830, 1702, 3179, 1155, 1961, 3051, 528,
+  1768, 716, 1469, 256, 2794, 2194, 1280, 3006, 780, 2394, 4059, 649, 2884, 1692, 750, 3090,
+  2107, 49, 2365, 1860, 3573, 1403, 2839, 1101, 95, 2988, 605, 2702, 1763, 372, 3686, 1339,
+  3100, 3741, 2713, 3514, 3060, 443, 762, 1300, 1736, 2684, 3530, 3093, 2626, 3777, 1026, 1550,
+  732, 380, 2737, 2232, 3417, 2913, 321, 2179, 3272, 3775, 425, 2331, 699, 3498, 190, 3758,
+  1173, 2967, 3678, 3305, 1951, 433, 3370, 1621, 2057, 356, 1485, 2593, 143, 3905, 2353, 3455,
+  1556, 3668, 987, 3332, 198, 2217, 4028, 1956, 1512, 3735, 3205, 1391, 4067, 2872, 1995, 2399,
+  1042, 40, 1749, 884, 2084, 3728, 2762, 3345, 116, 2077, 1115, 2315, 1365, 292, 2819, 2209,
+  3381, 2963, 3853, 615, 1508, 838, 2483, 1320, 645, 1998, 1405, 4032, 2663, 1629, 2196, 3292,
+  2512, 392, 2262, 1687, 1161, 3986, 2618, 994, 3786, 2818, 3518, 1120, 3269, 1970, 999, 439,
+  2516, 674, 3030, 1612, 2607, 901, 519, 3426, 2511, 381, 1030, 2335, 71, 839, 3315, 512,
+  3464, 1464, 2955, 2452, 221, 1373, 2391, 979, 2989, 3667, 325, 663, 3397, 1997, 4079, 91,
+  1759, 897, 1247, 2415, 3633, 1882, 3056, 3982, 2724, 978, 3080, 144, 1043, 2921, 1335, 811,
+  1894, 3916, 955, 105, 2997, 667, 2286, 183, 3226, 721, 1808, 2228, 562, 1422, 3613, 2983,
+  1208, 3899, 2054, 427, 3811, 3274, 1770, 2940, 814, 2144, 3483, 1850, 3630, 1215, 1598, 2725,
+  3952, 2241, 558, 3865, 3393, 1683, 579, 4035, 1881, 1490, 2533, 3922, 1673, 947, 3036, 1328,
+  2575, 3516, 1973, 151, 3161, 495, 1131, 68, 1690, 3609, 2261, 1779, 3424, 551, 3862, 46,
+  2841, 1372, 3235, 2414, 3651, 1503, 3474, 1852, 1314, 2438, 13, 3846, 2870, 2410, 202, 1793,
+  3244, 138, 1457, 2868, 1104, 2153, 1355, 305, 3954, 1256, 2821, 637, 2496, 2979, 2102, 213,
+  910, 1834, 3186, 1190, 797, 2885, 2145, 3218, 410, 800, 2898, 2174, 3238, 473, 2436, 697,
+  3194, 353, 4000, 2695, 1378, 3805, 2041, 3482, 2426, 450, 756, 3761, 2486, 2052, 3185, 2386,
+  3580, 491, 1811, 2703, 840, 2060, 341, 2761, 4029, 3046, 1633, 1049, 3376, 855, 4024, 2652,
+  961, 2260, 3453, 742, 2458, 22, 3627, 2657, 1671, 3241, 149, 1475, 3925, 366, 3229, 3737,
+  2601, 1360, 148, 2749, 1940, 3799, 88, 1225, 2654, 3825, 1075, 41, 1233, 3710, 1869, 3873,
+  1526, 2186, 1068, 1706, 682, 2307, 2856, 830, 3254, 1528, 2881, 1186, 212, 1455, 905, 1717,
+  1118, 2203, 4080, 239, 1283, 3854, 3164, 1108, 782, 486, 3581, 2005, 309, 1586, 2121, 552,
+  3787, 2755, 1871, 3994, 3042, 1821, 3170, 975, 593, 2006, 3719, 2215, 802, 1787, 1146, 599,
+  2013, 3374, 4091, 2346, 477, 1435, 3490, 2296, 1707, 3440, 1953, 3082, 1592, 2709, 167, 1106,
+  2890, 584, 3402, 2986, 3572, 297, 1635, 1214, 250, 3920, 1947, 3331, 2669, 4010, 428, 2751,
+  3396, 703, 1553, 3316, 2899, 541, 2398, 1729, 2177, 2688, 1359, 2461, 3139, 2764, 3524, 1381,
+  1689, 273, 1187, 463, 1496, 681, 2273, 3893, 2513, 2928, 1059, 3335, 2685, 3500, 2354, 1546,
+  2838, 332, 1035, 1652, 3625, 2530, 971, 3020, 652, 323, 2420, 724, 3544, 2220, 3302, 2034,
+  3644, 2383, 201, 1897, 891, 2453, 4052, 3143, 2646, 2223, 1003, 575, 1655, 3076, 2012, 3674,
+  278, 2965, 2502, 997, 1984, 1428, 3461, 131, 3772, 3296, 244, 3967, 705, 1154, 363, 3039,
+  828, 3328, 2333, 3502, 2692, 3721, 1210, 219, 1515, 365, 1859, 508, 1389, 59, 3974, 3155,
+  833, 3702, 2182, 2907, 754, 3141, 245, 1562, 3768, 2808, 1281, 4048, 257, 937, 1442, 408,
+  823, 1590, 2638, 3881, 1394, 3341, 1976, 485, 1446, 3634, 27, 3798, 2301, 746, 1170, 2408,
+  1375, 1901, 3764, 10, 3555, 2640, 853, 2835, 1232, 1935, 938, 1757, 2292, 3752, 1949, 2478,
+  4087, 2831, 1946, 944, 112, 1732, 3310, 2115, 3546, 3127, 4070, 2376, 3074, 964, 1830, 431,
+  2553, 1476, 3278, 19, 1299, 2124, 4003, 1920, 1056, 2185, 3227, 1654, 2895, 2455, 3914, 2756,
+  3233, 3755, 1209, 631, 2823, 107, 1060, 2939, 725, 1747, 2573, 2954, 1393, 3535, 134, 3953,
+  819, 3257, 570, 1648, 2302, 358, 4016, 1614, 556, 3050, 2561, 3347, 440, 1465, 3261, 45,
+  1276, 537, 1456, 3895, 3111, 2441, 550, 881, 2637, 1238, 714, 1602, 3730, 2734, 2162, 3616,
+  1188, 1985, 624, 3750, 1733, 3390, 412, 2743, 3591, 127, 809, 1975, 522, 3433, 1193, 1766,
+  2246, 12, 1988, 3109, 2287, 1622, 3733, 2101, 3508, 3243, 1086, 1965, 345, 3273, 2666, 1774,
+  2864, 2161, 1223, 3919, 3102, 1112, 2098, 3228, 2362, 3826, 81, 1139, 3560, 2706, 954, 2171,
+  2964, 3567, 2560, 359, 2089, 1329, 2949, 3945, 1819, 80, 2843, 2090, 253, 1269, 666, 2975,
+  171, 3950, 2674, 2256, 2863, 1092, 2435, 638, 1369, 3365, 2603, 3831, 1463, 2150, 289, 672,
+  2992, 973, 3539, 377, 3975, 843, 2490, 1285, 168, 2357, 478, 4092, 912, 2065, 1507, 500,
+  3460, 236, 2487, 2806, 707, 1858, 3647, 176, 895, 1500, 2031, 2936, 1697, 628, 3843, 1781,
+};
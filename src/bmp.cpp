@@ -0,0 +1,66 @@
+#include "bmp.h"
+#include <cstdint>
+#include <fstream>
+
+namespace {
+
+void put16(std::string& out, uint16_t value) {
+  out.push_back(static_cast<char>(value & 0xff));
+  out.push_back(static_cast<char>(value >> 8));
+}
+
+void put32(std::string& out, uint32_t value) {
+  put16(out, value & 0xffff);
+  put16(out, value >> 16);
+}
+
+}
+
+std::string encodeBmp(const Framebuffer& frame) {
+  const uint32_t headerSize = 54;
+  // Rows are padded to a multiple of four bytes
+  uint32_t rowSize = (frame.width * 3 + 3) & ~3u;
+  uint32_t imageSize = rowSize * frame.height;
+
+  std::string out;
+  out.reserve(headerSize + imageSize);
+
+  // File header
+  out += "BM";
+  put32(out, headerSize + imageSize);
+  put32(out, 0);
+  put32(out, headerSize);
+
+  // BITMAPINFOHEADER
+  put32(out, 40);
+  put32(out, frame.width);
+  put32(out, frame.height);
+  put16(out, 1);
+  put16(out, 24);
+  put32(out, 0);
+  put32(out, imageSize);
+  put32(out, 2835);  // 72 dpi
+  put32(out, 2835);
+  put32(out, 0);
+  put32(out, 0);
+
+  // Bottom row first, BGR
+  for (int y = frame.height - 1; y >= 0; y--) {
+    size_t rowStart = out.size();
+    for (int x = 0; x < frame.width; x++) {
+      const Color& color = frame.pixels[y * frame.width + x];
+      out.push_back(static_cast<char>(color.b));
+      out.push_back(static_cast<char>(color.g));
+      out.push_back(static_cast<char>(color.r));
+    }
+    out.resize(rowStart + rowSize, '\0');
+  }
+  return out;
+}
+
+bool saveBmp(const Framebuffer& frame, const std::string& file) {
+  std::ofstream out(file, std::ios::binary);
+  std::string encoded = encodeBmp(frame);
+  out.write(encoded.data(), encoded.size());
+  return static_cast<bool>(out);
+}
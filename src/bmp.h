@@ -0,0 +1,10 @@
+#pragma once
+
+#include <string>
+#include "framebuffer.h"
+
+// Uncompressed 24 bit BMP, simple enough to write without any library
+std::string encodeBmp(const Framebuffer& frame);
+
+// Returns false if the file can't be written
+bool saveBmp(const Framebuffer& frame, const std::string& file);
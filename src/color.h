@@ -45,6 +45,16 @@ struct Color {
         );
     }
 
+    // Overload the * operator to modulate colors channel by channel
+    Color operator*(const Color& other) const {
+        return Color(
+            int(r) * int(other.r) / 255,
+            int(g) * int(other.g) / 255,
+            int(b) * int(other.b) / 255,
+            int(a) * int(other.a) / 255
+        );
+    }
+
     // Friend function to allow float * Color
     friend Color operator*(float factor, const Color& color);
 };
\ No newline at end of file
@@ -3,6 +3,16 @@
 Cube::Cube(const glm::vec3& position, float sideLength, const Material& mat)
   : position(position), sideLength(sideLength), Object(mat) {}
 
+Bounds Cube::bounds() const {
+  float halfSideLength = sideLength / 2.0f;
+  return Bounds{position - glm::vec3(halfSideLength), position + glm::vec3(halfSideLength)};
+}
+
+void Cube::setPosition(const glm::vec3& newPosition) {
+  position = newPosition;
+  markChanged();
+}
+
 Intersect Cube::rayIntersect(const glm::vec3& rayOrigin, const glm::vec3& rayDirection) const {
   // Calculate half the side length for convenience
   float halfSideLength = sideLength / 2.0f;
@@ -59,19 +69,30 @@ Intersect Cube::rayIntersect(const glm::vec3& rayOrigin, const glm::vec3& rayDir
 
   // The ray intersects the AABB of the cube; calculate the intersection point and normal
   glm::vec3 point = rayOrigin + tmin * rayDirection;
-  glm::vec3 normal;
 
-  // Determine which face of the cube the intersection occurred on and set the normal accordingly
+  // Determine which face of the cube the intersection occurred on
+  int axis;
   if (tmin == tmax) {
     // Ray intersects one of the faces along the x-axis
-    normal = glm::vec3((point.x < position.x) ? -1.0f : 1.0f, 0.0f, 0.0f);
+    axis = 0;
   } else if (tymin == tymax) {
     // Ray intersects one of the faces along the y-axis
-    normal = glm::vec3(0.0f, (point.y < position.y) ? -1.0f : 1.0f, 0.0f);
+    axis = 1;
   } else {
     // Ray intersects one of the faces along the z-axis
-    normal = glm::vec3(0.0f, 0.0f, (point.z < position.z) ? -1.0f : 1.0f);
+    axis = 2;
   }
-
-  return Intersect{true, tmin, point, glm::normalize(normal)};
+  glm::vec3 normal(0.0f);
+  normal[axis] = (point[axis] < position[axis]) ? -1.0f : 1.0f;
+
+  // The texture is mapped onto that same face, so the tangent lies in the
+  // plane of the normal that is returned
+  int u = (axis + 1) % 3;
+  int v = (axis + 2) % 3;
+  glm::vec3 local = (point - position) / sideLength;
+  glm::vec2 uv(local[u] + 0.5f, local[v] + 0.5f);
+  glm::vec3 tangent(0.0f);
+  tangent[u] = 1.0f;
+
+  return Intersect{true, tmin, point, normal, uv, tangent, 1.0f / sideLength};
 }
\ No newline at end of file
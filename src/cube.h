@@ -10,6 +10,11 @@ public:
   Cube(const glm::vec3& position, float sideLength, const Material& mat);
 
   Intersect rayIntersect(const glm::vec3& rayOrigin, const glm::vec3& rayDirection) const override;
+  Bounds bounds() const override;
+
+  const glm::vec3& getPosition() const { return position; }
+  float getSideLength() const { return sideLength; }
+  void setPosition(const glm::vec3& newPosition);
 
 private:
   glm::vec3 position;
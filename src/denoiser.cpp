@@ -0,0 +1,105 @@
+#include "denoiser.h"
+#include <cmath>
+#include <utility>
+
+namespace {
+
+const float KERNEL[5] = { 1.0f / 16.0f, 1.0f / 4.0f, 3.0f / 8.0f, 1.0f / 4.0f, 1.0f / 16.0f };
+
+// Below this the albedo is too dark to divide the lighting out of the color
+const float MIN_ALBEDO = 0.01f;
+
+bool demodulates(const glm::vec3& albedo) {
+  return albedo.r > MIN_ALBEDO && albedo.g > MIN_ALBEDO && albedo.b > MIN_ALBEDO;
+}
+
+}
+
+Denoiser::Denoiser(ThreadPool& pool) : pool(pool) {}
+
+bool Denoiser::denoise(GBuffer& buffer, const std::atomic<bool>& cancel) {
+  int size = buffer.width * buffer.height;
+  irradiance.resize(size);
+  filtered.resize(size);
+
+  // Filter lighting rather than final color so texture and material detail
+  // in the albedo is not blurred away; it is multiplied back at the end
+  for (int i = 0; i < size; i++) {
+    irradiance[i] = demodulates(buffer.albedo[i]) ? buffer.color[i] / buffer.albedo[i] : buffer.color[i];
+  }
+
+  for (int iteration = 0; iteration < iterations; iteration++) {
+    if (cancel.load(std::memory_order_relaxed)) {
+      return false;
+    }
+
+    int step = 1 << iteration;
+    // Later passes average over more pixels, so they only need to remove smaller differences
+    float colorPhi = sigmaColor * std::pow(2.0f, -iteration);
+
+    pool.parallelFor(buffer.height, [&](int y) {
+      filterRow(buffer, y, step, colorPhi);
+    });
+    std::swap(irradiance, filtered);
+  }
+
+  for (int i = 0; i < size; i++) {
+    buffer.color[i] = demodulates(buffer.albedo[i]) ? irradiance[i] * buffer.albedo[i] : irradiance[i];
+  }
+  return true;
+}
+
+void Denoiser::filterRow(const GBuffer& buffer, int y, int step, float colorPhi) {
+  for (int x = 0; x < buffer.width; x++) {
+    int center = y * buffer.width + x;
+
+    // Background pixels come straight from the skybox and are never noisy
+    if (buffer.objectId[center] == SKY_ID) {
+      filtered[center] = irradiance[center];
+      continue;
+    }
+
+    const glm::vec3& centerColor = irradiance[center];
+    const glm::vec3& centerNormal = buffer.normal[center];
+    const glm::vec3& centerAlbedo = buffer.albedo[center];
+    float centerDepth = buffer.depth[center];
+    float depthPhi = sigmaDepth * centerDepth * step;
+
+    glm::vec3 sum(0.0f);
+    float weightSum = 0.0f;
+
+    for (int dy = -2; dy <= 2; dy++) {
+      int qy = y + dy * step;
+      if (qy < 0 || qy >= buffer.height) {
+        continue;
+      }
+      for (int dx = -2; dx <= 2; dx++) {
+        int qx = x + dx * step;
+        if (qx < 0 || qx >= buffer.width) {
+          continue;
+        }
+        int tap = qy * buffer.width + qx;
+        if (buffer.objectId[tap] == SKY_ID) {
+          continue;
+        }
+
+        glm::vec3 colorDelta = irradiance[tap] - centerColor;
+        float colorWeight = std::exp(-glm::dot(colorDelta, colorDelta) / (colorPhi * colorPhi));
+
+        float normalWeight = std::pow(std::max(0.0f, glm::dot(centerNormal, buffer.normal[tap])), sigmaNormal);
+
+        float depthWeight = std::exp(-std::abs(centerDepth - buffer.depth[tap]) / depthPhi);
+
+        glm::vec3 albedoDelta = buffer.albedo[tap] - centerAlbedo;
+        float albedoWeight = std::exp(-glm::dot(albedoDelta, albedoDelta) / (sigmaAlbedo * sigmaAlbedo));
+
+        float weight = KERNEL[dx + 2] * KERNEL[dy + 2] * colorWeight * normalWeight * depthWeight * albedoWeight;
+        sum += irradiance[tap] * weight;
+        weightSum += weight;
+      }
+    }
+
+    // The center tap always has weight, so weightSum is never zero here
+    filtered[center] = sum / weightSum;
+  }
+}
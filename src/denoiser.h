@@ -0,0 +1,32 @@
+#pragma once
+
+#include <atomic>
+#include <vector>
+#include <glm/glm.hpp>
+#include "gbuffer.h"
+#include "threadpool.h"
+
+// Edge-avoiding à-trous wavelet filter (Dammertz et al. 2010).
+// Each pass widens a 5x5 B3 spline kernel by doubling the tap spacing, and
+// every tap is weighted down by how much its color, normal, depth and albedo
+// differ from the center, so the blur stops at geometric and material edges.
+class Denoiser {
+public:
+  explicit Denoiser(ThreadPool& pool);
+
+  int iterations = 4;
+  float sigmaColor = 0.6f;
+  float sigmaNormal = 64.0f;
+  float sigmaDepth = 0.02f;
+  float sigmaAlbedo = 0.1f;
+
+  // Filters buffer.color in place. Stops early and returns false on cancel.
+  bool denoise(GBuffer& buffer, const std::atomic<bool>& cancel);
+
+private:
+  ThreadPool& pool;
+  std::vector<glm::vec3> irradiance;
+  std::vector<glm::vec3> filtered;
+
+  void filterRow(const GBuffer& buffer, int y, int step, float colorPhi);
+};
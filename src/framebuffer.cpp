@@ -0,0 +1,25 @@
+#include "framebuffer.h"
+#include <utility>
+
+FrameExchange::FrameExchange(int width, int height)
+  : buffers(3, Framebuffer(width, height)) {}
+
+Framebuffer& FrameExchange::backBuffer() {
+  return buffers[back];
+}
+
+void FrameExchange::publish() {
+  std::lock_guard<std::mutex> lock(mutex);
+  std::swap(back, ready);
+  fresh = true;
+}
+
+const Framebuffer* FrameExchange::acquire() {
+  std::lock_guard<std::mutex> lock(mutex);
+  if (!fresh) {
+    return nullptr;
+  }
+  std::swap(front, ready);
+  fresh = false;
+  return &buffers[front];
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <mutex>
+#include <vector>
+#include "color.h"
+
+// Color is laid out as r, g, b, a bytes, which is SDL_PIXELFORMAT_RGBA32
+struct Framebuffer {
+  int width;
+  int height;
+  std::vector<Color> pixels;
+
+  Framebuffer(int width, int height)
+    : width(width), height(height), pixels(width * height) {}
+
+  Color& at(int x, int y) {
+    return pixels[y * width + x];
+  }
+};
+
+// Triple buffering between the render thread and the presentation thread.
+// The renderer always has a back buffer to draw into, and the presenter always
+// gets the latest finished frame without ever waiting on a frame in flight.
+class FrameExchange {
+public:
+  FrameExchange(int width, int height);
+
+  // Render thread: the buffer to draw the next frame into
+  Framebuffer& backBuffer();
+
+  // Render thread: hands the finished back buffer over to the presenter
+  void publish();
+
+  // Presentation thread: the newest published frame, or nullptr if there is
+  // nothing new since the last call. Stays valid until the next acquire().
+  const Framebuffer* acquire();
+
+private:
+  std::mutex mutex;
+  std::vector<Framebuffer> buffers;
+  int back = 0;
+  int ready = 1;
+  int front = 2;
+  bool fresh = false;
+};
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <vector>
+
+const float SKY_DEPTH = 99999;
+const int SKY_ID = -1;
+
+// Per-pixel color plus the auxiliary features of the primary hit, which
+// the denoiser uses to tell real edges apart from noise
+struct GBuffer {
+  int width = 0;
+  int height = 0;
+  std::vector<glm::vec3> color;
+  std::vector<float> depth;
+  std::vector<glm::vec3> normal;
+  std::vector<glm::vec3> albedo;
+  std::vector<int> objectId;
+
+  void resize(int newWidth, int newHeight) {
+    width = newWidth;
+    height = newHeight;
+    int size = width * height;
+    color.assign(size, glm::vec3(0.0f));
+    depth.assign(size, SKY_DEPTH);
+    normal.assign(size, glm::vec3(0.0f));
+    albedo.assign(size, glm::vec3(0.0f));
+    objectId.assign(size, SKY_ID);
+  }
+};
@@ -0,0 +1,160 @@
+#include "image.h"
+#include <SDL_image.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <print.h>
+
+namespace {
+
+const uint32_t CACHE_MAGIC = 0x31474D49; // "IMG1"
+
+// Identifies the source the cache was built from, so edits invalidate it
+struct CacheHeader {
+  uint32_t magic;
+  int32_t width;
+  int32_t height;
+  int64_t sourceTime;
+  uint64_t sourceSize;
+};
+
+bool sourceStamp(const std::string& file, int64_t& time, uint64_t& size) {
+  std::error_code error;
+  auto writeTime = std::filesystem::last_write_time(file, error);
+  if (error) {
+    return false;
+  }
+  size = std::filesystem::file_size(file, error);
+  time = writeTime.time_since_epoch().count();
+  return !error;
+}
+
+bool validHeader(const CacheHeader& header, int64_t sourceTime, uint64_t sourceSize) {
+  return header.magic == CACHE_MAGIC && header.sourceTime == sourceTime &&
+         header.sourceSize == sourceSize && header.width > 0 && header.height > 0;
+}
+
+bool readCache(const std::string& file, int64_t sourceTime, uint64_t sourceSize, Image& image) {
+  std::ifstream in(file + ".cache", std::ios::binary);
+  CacheHeader header;
+  if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || !validHeader(header, sourceTime, sourceSize)) {
+    return false;
+  }
+
+  image.width = header.width;
+  image.height = header.height;
+  image.pixels.resize(size_t(header.width) * header.height);
+  return bool(in.read(reinterpret_cast<char*>(image.pixels.data()), image.pixels.size() * sizeof(Color)));
+}
+
+bool writeCache(const std::string& file, int64_t sourceTime, uint64_t sourceSize, const Image& image) {
+  // Written under a temporary name and renamed, so a reader never sees half a file
+  std::string temporary = file + ".cache.tmp";
+  {
+    std::ofstream out(temporary, std::ios::binary);
+    CacheHeader header{CACHE_MAGIC, image.width, image.height, sourceTime, sourceSize};
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    out.write(reinterpret_cast<const char*>(image.pixels.data()), image.pixels.size() * sizeof(Color));
+    if (!out) {
+      return false;
+    }
+  }
+  std::error_code error;
+  std::filesystem::rename(temporary, file + ".cache", error);
+  return !error;
+}
+
+bool decode(const std::string& file, Image& image) {
+  SDL_Surface* loaded = IMG_Load(file.c_str());
+  if (!loaded) {
+    print("Failed to load image:", IMG_GetError());
+    return false;
+  }
+  SDL_Surface* surface = SDL_ConvertSurfaceFormat(loaded, SDL_PIXELFORMAT_RGBA32, 0);
+  SDL_FreeSurface(loaded);
+  if (!surface) {
+    print("Failed to convert image:", SDL_GetError());
+    return false;
+  }
+
+  image.width = surface->w;
+  image.height = surface->h;
+  image.pixels.resize(size_t(surface->w) * surface->h);
+  for (int y = 0; y < surface->h; y++) {
+    const Uint8* row = static_cast<const Uint8*>(surface->pixels) + y * surface->pitch;
+    for (int x = 0; x < surface->w; x++) {
+      const Uint8* pixel = row + x * 4;
+      image.pixels[y * surface->w + x] = Color(pixel[0], pixel[1], pixel[2], pixel[3]);
+    }
+  }
+  SDL_FreeSurface(surface);
+  return true;
+}
+
+}
+
+bool loadImage(const std::string& file, Image& image) {
+  int64_t sourceTime;
+  uint64_t sourceSize;
+  if (!sourceStamp(file, sourceTime, sourceSize)) {
+    print("Image not found:", file);
+    return false;
+  }
+  if (readCache(file, sourceTime, sourceSize, image)) {
+    return true;
+  }
+  if (!decode(file, image)) {
+    return false;
+  }
+  writeCache(file, sourceTime, sourceSize, image);
+  return true;
+}
+
+ImageFile::~ImageFile() {
+  if (descriptor >= 0) {
+    close(descriptor);
+  }
+}
+
+bool ImageFile::open(const std::string& file) {
+  int64_t sourceTime;
+  uint64_t sourceSize;
+  if (!sourceStamp(file, sourceTime, sourceSize)) {
+    print("Image not found:", file);
+    return false;
+  }
+
+  CacheHeader header;
+  {
+    std::ifstream in(file + ".cache", std::ios::binary);
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header)) || !validHeader(header, sourceTime, sourceSize)) {
+      // The decoded image is only held here, until it is on disk
+      Image image;
+      if (!decode(file, image)) {
+        return false;
+      }
+      if (!writeCache(file, sourceTime, sourceSize, image)) {
+        print("Unable to write", file + ".cache");
+        return false;
+      }
+      header = CacheHeader{CACHE_MAGIC, image.width, image.height, sourceTime, sourceSize};
+    }
+  }
+
+  descriptor = ::open((file + ".cache").c_str(), O_RDONLY);
+  if (descriptor < 0) {
+    print("Unable to read", file + ".cache");
+    return false;
+  }
+  width = header.width;
+  height = header.height;
+  return true;
+}
+
+bool ImageFile::readRow(int x, int y, int count, Color* pixels) const {
+  size_t bytes = size_t(count) * sizeof(Color);
+  off_t offset = sizeof(CacheHeader) + (off_t(y) * width + x) * sizeof(Color);
+  return pread(descriptor, pixels, bytes, offset) == static_cast<ssize_t>(bytes);
+}
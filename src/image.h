@@ -0,0 +1,41 @@
+#pragma once
+#include <string>
+#include <vector>
+#include "color.h"
+
+struct Image {
+  int width = 0;
+  int height = 0;
+  std::vector<Color> pixels;
+};
+
+// Decodes an image file to RGBA. The decoded pixels are written next to the
+// source as <file>.cache and read back directly on later runs, as long as the
+// source has not changed since. Returns false if the image can't be loaded.
+bool loadImage(const std::string& file, Image& image);
+
+// Reads pixels of an image straight from its <file>.cache, so the image is
+// never held in memory as a whole. Reads use pread and any number of threads
+// can share one ImageFile.
+class ImageFile {
+public:
+  ImageFile() = default;
+  ImageFile(const ImageFile&) = delete;
+  ImageFile& operator=(const ImageFile&) = delete;
+  ~ImageFile();
+
+  // Decodes file and writes its cache first if that is missing or stale.
+  // Returns false if the image can't be loaded or the cache can't be written.
+  bool open(const std::string& file);
+
+  // Reads count pixels of row y starting at column x
+  bool readRow(int x, int y, int count, Color* pixels) const;
+
+  int getWidth() const { return width; }
+  int getHeight() const { return height; }
+
+private:
+  int descriptor = -1;
+  int width = 0;
+  int height = 0;
+};
@@ -7,5 +7,10 @@ struct Intersect {
   float dist = 0.0f;
   glm::vec3 point;
   glm::vec3 normal;
+  // Surface parametrization for texture lookups
+  glm::vec2 uv = glm::vec2(0.0f);
+  glm::vec3 tangent = glm::vec3(0.0f);
+  // uv units per world unit around the hit, to turn a ray footprint into texture space
+  float uvScale = 0.0f;
 };
 
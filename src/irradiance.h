@@ -0,0 +1,73 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <glm/glm.hpp>
+
+// Spacing of the world-space lattice irradiance records are placed on
+const float IRRADIANCE_CELL_SIZE = 0.05f;
+
+// Irradiance gathered at one lattice site and how it changes along the two
+// world axes of the site's plane, used to extrapolate it to nearby points
+struct IrradianceRecord {
+  glm::vec3 irradiance{0.0f};
+  glm::vec3 gradientU{0.0f};
+  glm::vec3 gradientV{0.0f};
+  // False for sites inside geometry, which are left out of interpolation
+  bool valid = false;
+};
+
+// Fixed-size open-addressing hash of irradiance records, shared by all render
+// threads without locks. A thread claims a record by swapping its key into an
+// empty slot, fills it and publishes it with a release store. Records only
+// depend on their key, so a thread that finds one still being filled computes
+// its own copy instead of waiting, and the image doesn't depend on timing.
+class IrradianceCache {
+public:
+  // capacity must be a power of two
+  explicit IrradianceCache(int capacity = 1 << 16)
+    : capacity(capacity), slots(new Slot[capacity]) {}
+
+  // Returns the record for key, calling compute to fill it if it is missing
+  template <typename Compute>
+  IrradianceRecord fetch(uint64_t key, Compute compute) {
+    uint64_t start = (key * 0x9E3779B97F4A7C15ull) >> 32;
+    for (int probe = 0; probe < MAX_PROBES; probe++) {
+      Slot& slot = slots[(start + probe) & (capacity - 1)];
+      uint64_t current = slot.key.load(std::memory_order_acquire);
+      if (current == 0 && slot.key.compare_exchange_strong(current, key, std::memory_order_acq_rel)) {
+        slot.record = compute();
+        slot.ready.store(true, std::memory_order_release);
+        return slot.record;
+      }
+      // current holds whichever key is in the slot now, ours if another thread was first
+      if (current == key) {
+        return slot.ready.load(std::memory_order_acquire) ? slot.record : compute();
+      }
+    }
+    // The neighbourhood of key is full, the record is not cached
+    return compute();
+  }
+
+  // Drops every record. Must not run while any thread is fetching.
+  void clear() {
+    for (int i = 0; i < capacity; i++) {
+      slots[i].key.store(0, std::memory_order_relaxed);
+      slots[i].ready.store(false, std::memory_order_relaxed);
+    }
+  }
+
+private:
+  static const int MAX_PROBES = 32;
+
+  struct Slot {
+    // 0 while the slot is free
+    std::atomic<uint64_t> key{0};
+    std::atomic<bool> ready{false};
+    IrradianceRecord record;
+  };
+
+  int capacity;
+  std::unique_ptr<Slot[]> slots;
+};
@@ -7,6 +7,13 @@ struct Light {
   glm::vec3 position;
   float intensity;
   Color color;
-      Light(glm::vec3 position, float intensity, Color color) 
-        : position(position), intensity(intensity), color(color) {}
+  // Radius of the disk the light is sampled on for soft shadows; 0 is a point light
+  float radius;
+  // Counts edits, so renderers can tell the light changed since a frame
+  unsigned revision = 0;
+      Light(glm::vec3 position, float intensity, Color color, float radius = 0.0f) 
+        : position(position), intensity(intensity), color(color), radius(radius) {}
+
+  // Call after editing the light
+  void markChanged() { revision++; }
 };
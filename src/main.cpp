@@ -1,10 +1,20 @@
 #include <SDL2/SDL.h>
 #include <SDL_events.h>
 #include <SDL_render.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
 #include <cstdlib>
+#include <filesystem>
 #include <glm/ext/quaternion_geometric.hpp>
 #include <glm/geometric.hpp>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
 #include <string>
+#include <thread>
 #include <glm/glm.hpp>
 #include <vector>
 #include <print.h>
@@ -17,95 +27,47 @@
 #include "light.h"
 #include "camera.h"
 #include "skybox.h"
+#include "scene.h"
+#include "framebuffer.h"
+#include "renderer.h"
+#include "threadpool.h"
+#include "server.h"
+#include "bmp.h"
+#include "replay.h"
+#include "texture.h"
 
 Skybox skybox("src/skybox.jpg");
 const int SCREEN_WIDTH = 800;
 const int SCREEN_HEIGHT = 600;
-const float ASPECT_RATIO = static_cast<float>(SCREEN_WIDTH) / static_cast<float>(SCREEN_HEIGHT);
-const int MAX_RECURSION = 3;
-const float BIAS = 0.0001f;
 
 SDL_Renderer* renderer;
-std::vector<Object*> objects;
-Light light(glm::vec3(-1.0, 0, 10), 1.5f, Color(255, 255, 255));
+Scene scene{{}, Light(glm::vec3(-1.0, 0, 10), 1.5f, Color(255, 255, 255)), &skybox};
 Camera camera(glm::vec3(0.0, 0.0, 5.0f), glm::vec3(0.0f, 0.0f, 0.0f), glm::vec3(0.0f, 1.0f, 0.0f), 10.0f);
-
-
-void point(glm::vec2 position, Color color) {
-    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
-    SDL_RenderDrawPoint(renderer, position.x, position.y);
-}
-
-float castShadow(const glm::vec3& shadowOrigin, const glm::vec3& lightDir, Object* hitObject) {
-    for (auto& obj : objects) {
-        if (obj != hitObject) {
-            Intersect shadowIntersect = obj->rayIntersect(shadowOrigin, lightDir);
-            if (shadowIntersect.isIntersecting && shadowIntersect.dist > 0) {
-                float shadowRatio = shadowIntersect.dist / glm::length(light.position - shadowOrigin);
-                shadowRatio = glm::min(1.0f, shadowRatio);
-                return 1.0f - shadowRatio;
-            }
-        }
-    }
-    return 1.0f;
-}
-
-Color castRay(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, const short recursion = 0) {
-    float zBuffer = 99999;
-    Object* hitObject = nullptr;
-    Intersect intersect;
-
-    for (const auto& object : objects) {
-        Intersect i = object->rayIntersect(rayOrigin, rayDirection);
-        if (i.isIntersecting && i.dist < zBuffer) {
-            zBuffer = i.dist;
-            hitObject = object;
-            intersect = i;
-        }
-    }
-
-    if (!intersect.isIntersecting || recursion == MAX_RECURSION) {
-        glm::vec3 skyboxColor = skybox.getColor(rayDirection);
-        return Color(skyboxColor.r, skyboxColor.g, skyboxColor.b);
-    }
-
-
-    glm::vec3 lightDir = glm::normalize(light.position - intersect.point);
-    glm::vec3 viewDir = glm::normalize(rayOrigin - intersect.point);
-    glm::vec3 reflectDir = glm::reflect(-lightDir, intersect.normal); 
-
-    float shadowIntensity = castShadow(intersect.point, lightDir, hitObject);
-
-    float diffuseLightIntensity = std::max(0.0f, glm::dot(intersect.normal, lightDir));
-    float specReflection = glm::dot(viewDir, reflectDir);
-    
-    Material mat = hitObject->material;
-
-    float specLightIntensity = std::pow(std::max(0.0f, glm::dot(viewDir, reflectDir)), mat.specularCoefficient);
-
-
-    Color reflectedColor(0.0f, 0.0f, 0.0f);
-    if (mat.reflectivity > 0) {
-        glm::vec3 origin = intersect.point + intersect.normal * BIAS;
-        reflectedColor = castRay(origin, reflectDir, recursion + 1); 
-    }
-
-    Color refractedColor(0.0f, 0.0f, 0.0f);
-    if (mat.transparency > 0) {
-        glm::vec3 origin = intersect.point - intersect.normal * BIAS;
-        glm::vec3 refractDir = glm::refract(rayDirection, intersect.normal, mat.refractionIndex);
-        refractedColor = castRay(origin, refractDir, recursion + 1); 
-    }
-
-
-
-    Color diffuseLight = mat.diffuse * light.intensity * diffuseLightIntensity * mat.albedo * shadowIntensity;
-    Color specularLight = light.color * light.intensity * specLightIntensity * mat.specularAlbedo * shadowIntensity;
-    Color color = (diffuseLight + specularLight) * (1.0f - mat.reflectivity - mat.transparency) + reflectedColor * mat.reflectivity + refractedColor * mat.transparency;
-    return color;
-}
-
-void setUpPokeball() {
+RenderSettings settings;
+// Edited by the event thread, moved into the scene by the render thread between frames
+glm::vec3 lightPosition = scene.light.position;
+
+// The event thread edits the camera and settings under this mutex and raises
+// cancelFrame, the render thread copies them under the same mutex when a frame starts
+std::mutex cameraMutex;
+std::atomic<bool> cancelFrame{false};
+// Wakes an idle render thread once cancelFrame is raised
+std::condition_variable sceneChanged;
+// Pushed by the render thread for every published frame, to wake the event thread
+Uint32 frameReadyEvent = 0;
+std::atomic<bool> running{true};
+std::atomic<int> framesRendered{0};
+
+// Set with --record; logs every handled key press with the state it led to
+InputRecorder* recorder = nullptr;
+Uint32 recordingStart = 0;
+
+// Set with --texture; mapped onto the white half of the pokeball
+const Texture* pokeballTexture = nullptr;
+// Tiles of every texture, 1 MiB
+const size_t TEXTURE_CACHE_TILES = 4096;
+
+void setUpPokeball(std::vector<Object*>& objects) {
     // Parte roja de la Pokébola
     Material red = {
         Color(255, 0, 0),
@@ -282,6 +244,7 @@ void setUpPokeball() {
     0.0f,                   // Transmitancia
     0.0f                    // Índice de refracción
     };
+    white.diffuseMap = pokeballTexture;
 
     // Añadir cubos para la parte blanca
         //primer circulo
@@ -412,42 +375,281 @@ void setUpPokeball() {
 }
 
 
-void render() {
-    float fov = 3.1415/3;
-    for (int y = 0; y < SCREEN_HEIGHT; y++) {
-        for (int x = 0; x < SCREEN_WIDTH; x++) {
-            /*
-            float random_value = static_cast<float>(std::rand())/static_cast<float>(RAND_MAX);
-            if (random_value < 0.0) {
+// Moves edits made on the event thread into the scene, only called between frames
+void applySceneEdits() {
+    if (scene.light.position != lightPosition) {
+        scene.light.position = lightPosition;
+        scene.light.markChanged();
+    }
+}
+
+InputEvent inputState(SDL_Keycode key) {
+    return InputEvent{SDL_GetTicks() - recordingStart, key, camera, lightPosition, settings};
+}
+
+// Keeps rendering frames into the exchange until running goes false. A frame
+// is started over with the new camera as soon as input cancels it.
+void renderLoop(Renderer& raytracer, FrameExchange& frames) {
+    while (running) {
+        RenderSettings latchedSettings;
+        Camera latched = [&] {
+            std::lock_guard<std::mutex> lock(cameraMutex);
+            cancelFrame = false;
+            latchedSettings = settings;
+            applySceneEdits();
+            return camera;
+        }();
+
+        if (raytracer.render(latched, latchedSettings, frames.backBuffer(), cancelFrame)) {
+            // Nothing changed, the frame on screen is still current
+            if (raytracer.regionsRendered() == 0) {
+                std::unique_lock<std::mutex> lock(cameraMutex);
+                sceneChanged.wait(lock, [] { return cancelFrame || !running; });
                 continue;
             }
-            */
+            frames.publish();
+            framesRendered++;
+
+            SDL_Event ready{};
+            ready.type = frameReadyEvent;
+            SDL_PushEvent(&ready);
+        }
+    }
+}
+
+// Applies a key to the camera, light or settings. Returns false for keys that do nothing.
+bool applyKey(SDL_Keycode key) {
+    switch(key) {
+        case SDLK_UP:
+            camera.move(1.0f);
+            break;
+        case SDLK_DOWN:
+            camera.move(-1.0f);
+            break;
+        case SDLK_LEFT:
+            camera.rotate(-1.0f, 0.0f);
+            break;
+        case SDLK_RIGHT:
+            camera.rotate(1.0f, 0.0f);
+            break;
+        case SDLK_RETURN: //enter
+            camera.rotate(0.0f, 1.0f);
+            break;
+        case SDLK_SPACE:
+            camera.rotate(0.0f, -1.0f);
+            break;
+        case SDLK_j:
+            lightPosition.x -= 0.5f;
+            break;
+        case SDLK_l:
+            lightPosition.x += 0.5f;
+            break;
+        case SDLK_i:
+            lightPosition.y += 0.5f;
+            break;
+        case SDLK_k:
+            lightPosition.y -= 0.5f;
+            break;
+        case SDLK_n:
+            settings.denoise = !settings.denoise;
+            break;
+        case SDLK_h:
+            settings.hybrid = !settings.hybrid;
+            break;
+        case SDLK_b:
+            settings.blueNoise = !settings.blueNoise;
+            break;
+        case SDLK_g:
+            settings.indirect = !settings.indirect;
+            break;
+        case SDLK_1:
+        case SDLK_2:
+        case SDLK_3:
+        case SDLK_4:
+            settings.samplesPerPixel = key - SDLK_1 + 1;
+            break;
+        default:
+            return false;
+    }
+    return true;
+}
 
+void handleKey(SDL_Keycode key) {
+    std::optional<InputEvent> event;
+    {
+        std::lock_guard<std::mutex> lock(cameraMutex);
+        if (!applyKey(key)) {
+            return;
+        }
+        // The frame in flight uses a stale camera or settings, drop it and start over
+        cancelFrame = true;
+        if (recorder) {
+            event = inputState(key);
+        }
+    }
+    sceneChanged.notify_one();
+
+    // Written after the lock is released, so the render thread never waits on the disk
+    if (event) {
+        recorder->record(*event);
+    }
+}
 
-            float screenX = (2.0f * (x + 0.5f)) / SCREEN_WIDTH - 1.0f;
-            float screenY = -(2.0f * (y + 0.5f)) / SCREEN_HEIGHT + 1.0f;
-            screenX *= ASPECT_RATIO;
-            screenX *= tan(fov/2.0f);
-            screenY *= tan(fov/2.0f);
+// Headless mode: keeps the scene resident and answers render requests
+int runServer(int port) {
+    Scene pokeball{{}, scene.light, &skybox};
+    setUpPokeball(pokeball.objects);
+    // Served images must not depend on when the request arrived
+    skybox.loadAsync();
+    skybox.waitUntilLoaded();
+
+    ThreadPool pool;
+    RenderServer server({{"pokeball", &pokeball}}, pool);
+    return server.serve(port) ? 0 : 1;
+}
 
+// Renders views all around the Pokeball as one batch into turntable_<n>.bmp
+int runTurntable(int viewCount) {
+    setUpPokeball(scene.objects);
+    skybox.loadAsync();
+    skybox.waitUntilLoaded();
+
+    ThreadPool pool;
+    Renderer raytracer(scene, pool);
+    std::vector<Framebuffer> frames(viewCount, Framebuffer(320, 240));
+    std::vector<View> views;
+    for (int i = 0; i < viewCount; i++) {
+        Camera turned = camera;
+        turned.rotate(360.0f * i / viewCount / camera.rotationSpeed, 0.0f);
+        views.push_back(View{turned, Projection::PERSPECTIVE, &frames[i]});
+    }
 
-            glm::vec3 cameraDir = glm::normalize(camera.target - camera.position);
+    std::atomic<bool> neverCancel{false};
+    auto startTime = std::chrono::steady_clock::now();
+    raytracer.renderBatch(views, settings, neverCancel);
+    auto elapsed = std::chrono::steady_clock::now() - startTime;
+    print("Rendered", viewCount, "views in", std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), "ms");
 
-            glm::vec3 cameraX = glm::normalize(glm::cross(cameraDir, camera.up));
-            glm::vec3 cameraY = glm::normalize(glm::cross(cameraX, cameraDir));
-            glm::vec3 rayDirection = glm::normalize(
-                cameraDir + cameraX * screenX + cameraY * screenY
-            );
-           
-            Color pixelColor = castRay(camera.position, rayDirection);
-            /* Color pixelColor = castRay(glm::vec3(0,0,20), glm::normalize(glm::vec3(screenX, screenY, -1.0f))); */
+    for (int i = 0; i < viewCount; i++) {
+        if (!saveBmp(frames[i], "turntable_" + std::to_string(i) + ".bmp")) {
+            print("Unable to write turntable_" + std::to_string(i) + ".bmp");
+            return 1;
+        }
+    }
+    return 0;
+}
 
-            point(glm::vec2(x, y), pixelColor);
+// Renders every state of a recording once, in order and without cancelling,
+// and writes the frame times and checksums to outDir/times.csv. With a
+// baseline directory from an earlier replay, the two runs are compared.
+int runReplay(const std::string& log, const std::string& outDir, bool dumpFrames, const std::string& baselineDir) {
+    std::vector<InputEvent> events;
+    if (!loadRecording(log, events) || events.empty()) {
+        print("Unable to read recording", log);
+        return 1;
+    }
+    std::error_code error;
+    std::filesystem::create_directories(outDir, error);
+
+    setUpPokeball(scene.objects);
+    skybox.loadAsync();
+    skybox.waitUntilLoaded();
+
+    ThreadPool pool;
+    Renderer raytracer(scene, pool);
+    Framebuffer frame(SCREEN_WIDTH, SCREEN_HEIGHT);
+    std::atomic<bool> neverCancel{false};
+    std::vector<FrameTiming> timings;
+
+    for (int i = 0; i < static_cast<int>(events.size()); i++) {
+        // Recorded states are applied as they are, so the camera path stays the
+        // same even if the camera code of this build behaves differently
+        camera = events[i].camera;
+        lightPosition = events[i].lightPosition;
+        settings = events[i].settings;
+        applySceneEdits();
+
+        auto frameStart = std::chrono::steady_clock::now();
+        raytracer.render(camera, settings, frame, neverCancel);
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - frameStart;
+        timings.push_back(FrameTiming{i, events[i].key, elapsed.count(), frameChecksum(frame)});
+
+        std::string frameFile = outDir + "/frame_" + std::to_string(i) + ".bmp";
+        if (dumpFrames && !saveBmp(frame, frameFile)) {
+            print("Unable to write", frameFile);
+            return 1;
         }
     }
+
+    if (!saveTimings(timings, outDir + "/times.csv")) {
+        print("Unable to write", outDir + "/times.csv");
+        return 1;
+    }
+    if (baselineDir.empty()) {
+        return 0;
+    }
+
+    std::vector<FrameTiming> baseline;
+    if (!loadTimings(baselineDir + "/times.csv", baseline)) {
+        print("Unable to read", baselineDir + "/times.csv");
+        return 1;
+    }
+    return compareTimings(timings, baseline) ? 0 : 1;
 }
 
 int main(int argc, char* argv[]) {
+    auto startTime = std::chrono::steady_clock::now();
+
+    // GAME --texture <image> [mode...]
+    TextureCache textureCache(TEXTURE_CACHE_TILES);
+    std::optional<Texture> texture;
+    if (argc >= 3 && std::string(argv[1]) == "--texture") {
+        try {
+            texture.emplace(Texture::fromFile(argv[2], textureCache));
+        } catch (const std::runtime_error& error) {
+            print(error.what());
+            return 1;
+        }
+        pokeballTexture = &*texture;
+        argc -= 2;
+        argv += 2;
+    }
+
+    // GAME --server [port]
+    if (argc >= 2 && std::string(argv[1]) == "--server") {
+        return runServer(argc >= 3 ? std::atoi(argv[2]) : 8080);
+    }
+
+    // GAME --turntable [views]
+    if (argc >= 2 && std::string(argv[1]) == "--turntable") {
+        return runTurntable(argc >= 3 ? std::max(1, std::atoi(argv[2])) : 12);
+    }
+
+    // GAME --replay <log> <outdir> [--frames] [--baseline <dir>]
+    if (argc >= 4 && std::string(argv[1]) == "--replay") {
+        bool dumpFrames = false;
+        std::string baselineDir;
+        for (int i = 4; i < argc; i++) {
+            std::string option = argv[i];
+            if (option == "--frames") {
+                dumpFrames = true;
+            } else if (option == "--baseline" && i + 1 < argc) {
+                baselineDir = argv[++i];
+            }
+        }
+        return runReplay(argv[2], argv[3], dumpFrames, baselineDir);
+    }
+
+    // GAME --record <log>
+    std::unique_ptr<InputRecorder> inputLog;
+    if (argc >= 3 && std::string(argv[1]) == "--record") {
+        inputLog = std::make_unique<InputRecorder>(argv[2]);
+        if (!inputLog->isOpen()) {
+            print("Unable to write", argv[2]);
+            return 1;
+        }
+    }
+
     // Initialize SDL
     if (SDL_Init(SDL_INIT_VIDEO) < 0) {
         SDL_Log("Unable to initialize SDL: %s", SDL_GetError());
@@ -476,72 +678,99 @@ int main(int argc, char* argv[]) {
         return 1;
     }
 
-    bool running = true;
+    // Frames are uploaded here and drawn as one textured quad
+    SDL_Texture* screenTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32,
+                                                   SDL_TEXTUREACCESS_STREAMING,
+                                                   SCREEN_WIDTH, SCREEN_HEIGHT);
+
+    if (!screenTexture) {
+        SDL_Log("Unable to create texture: %s", SDL_GetError());
+        SDL_DestroyRenderer(renderer);
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        return 1;
+    }
+
     SDL_Event event;
 
-    int frameCount = 0;
-    Uint32 startTime = SDL_GetTicks();
-    Uint32 currentTime = startTime;
+    Uint32 currentTime = SDL_GetTicks();
+    bool firstFramePresented = false;
     
-    setUpPokeball();
+    setUpPokeball(scene.objects);
 
-    while (running) {
-        while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                running = false;
-            }
+    if (inputLog) {
+        recorder = inputLog.get();
+        recordingStart = SDL_GetTicks();
+        recorder->record(inputState(0));
+    }
 
-            if (event.type == SDL_KEYDOWN) {
-                switch(event.key.keysym.sym) {
-                    case SDLK_UP:
-                        camera.move(1.0f);
-                        break;
-                    case SDLK_DOWN:
-                        camera.move(-1.0f);
-                        break;
-                    case SDLK_LEFT:
-                        camera.rotate(-1.0f, 0.0f);
-                        break;
-                    case SDLK_RIGHT:
-                        camera.rotate(1.0f, 0.0f);
-                        break;
-                    case SDLK_RETURN: //enter
-                        camera.rotate(0.0f, 1.0f);
-                        break;
-                    case SDLK_SPACE:
-                        camera.rotate(0.0f, -1.0f);
-                        break;
+    // Rendering starts right away on the placeholder sky, the frame in
+    // flight is restarted once the real one is decoded
+    skybox.loadAsync([] {
+        std::lock_guard<std::mutex> lock(cameraMutex);
+        cancelFrame = true;
+        sceneChanged.notify_one();
+    });
+
+    ThreadPool pool;
+    Renderer raytracer(scene, pool);
+    FrameExchange frames(SCREEN_WIDTH, SCREEN_HEIGHT);
+    frameReadyEvent = SDL_RegisterEvents(1);
+    std::thread renderThread(renderLoop, std::ref(raytracer), std::ref(frames));
+
+    // This thread only handles input and presentation, so key presses are
+    // seen right away no matter how long a frame takes to trace
+    while (running) {
+        // Sleeps until there is input or a new frame to show
+        if (SDL_WaitEvent(&event)) {
+            do {
+                if (event.type == SDL_QUIT) {
+                    running = false;
                 }
-            }
-
 
+                if (event.type == SDL_KEYDOWN) {
+                    handleKey(event.key.keysym.sym);
+                }
+            } while (SDL_PollEvent(&event));
         }
 
-        // Clear the screen
-        SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-        SDL_RenderClear(renderer);
+        if (const Framebuffer* frame = frames.acquire()) {
+            SDL_UpdateTexture(screenTexture, nullptr, frame->pixels.data(), frame->width * sizeof(Color));
+            SDL_RenderCopy(renderer, screenTexture, nullptr, nullptr);
 
-        render();
+            // Present the renderer
+            SDL_RenderPresent(renderer);
 
-        // Present the renderer
-        SDL_RenderPresent(renderer);
-
-        frameCount++;
+            if (!firstFramePresented) {
+                firstFramePresented = true;
+                auto elapsed = std::chrono::steady_clock::now() - startTime;
+                print("Time to first frame:", std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), "ms");
+            }
+        }
 
         // Calculate and display FPS
         if (SDL_GetTicks() - currentTime >= 1000) {
             currentTime = SDL_GetTicks();
-            std::string title = "Raycasting  - FPS: " + std::to_string(frameCount);
+            std::string title = "Raycasting  - FPS: " + std::to_string(framesRendered.exchange(0));
             SDL_SetWindowTitle(window, title.c_str());
-            frameCount = 0;
         }
     }
 
+    {
+        std::lock_guard<std::mutex> lock(cameraMutex);
+        cancelFrame = true;
+    }
+    sceneChanged.notify_one();
+    renderThread.join();
+    // The loader's callback uses globals that are destroyed before the skybox,
+    // so it must be done before main returns
+    skybox.waitUntilLoaded();
+
     // Cleanup
+    SDL_DestroyTexture(screenTexture);
     SDL_DestroyRenderer(renderer);
     SDL_DestroyWindow(window);
     SDL_Quit();
 
     return 0;
 }
-
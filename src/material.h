@@ -2,6 +2,8 @@
 
 #include "color.h"
 
+class Texture;
+
 struct Material {
   Color diffuse;
   float albedo;
@@ -10,4 +12,11 @@ struct Material {
   float reflectivity;
   float transparency;
   float refractionIndex;
+  // Spread of glossy reflections, 0 for a perfect mirror and 1 for a full hemisphere
+  float roughness = 0.0f;
+  // Optional maps; diffuse multiplies the diffuse color, specular scales
+  // specularAlbedo by its red channel, normal is a tangent space normal map
+  const Texture* diffuseMap = nullptr;
+  const Texture* specularMap = nullptr;
+  const Texture* normalMap = nullptr;
 };
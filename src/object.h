@@ -3,11 +3,27 @@
 #include <glm/glm.hpp>
 #include "material.h"
 #include "intersect.h"
+#include "shading.h"
+
+// Axis-aligned box enclosing an object
+struct Bounds {
+  glm::vec3 min;
+  glm::vec3 max;
+};
 
 class Object {
 public:
-  Object(const Material& mat) : material(mat) {}
+  Object(const Material& mat) : material(mat), features(classifyMaterial(mat)) {}
   virtual Intersect rayIntersect(const glm::vec3& rayOrigin, const glm::vec3& rayDirection) const = 0;
-  
+  virtual Bounds bounds() const = 0;
+
+  // Call after editing the object, so renderers redraw what it touched
+  void markChanged() {
+    features = classifyMaterial(material);
+    revision++;
+  }
+
   Material material;
+  uint8_t features;
+  unsigned revision = 0;
 };
@@ -0,0 +1,207 @@
+#include "rasterizer.h"
+#include <algorithm>
+#include <cmath>
+#include "cube.h"
+#include "sphere.h"
+
+namespace {
+
+// Primitives with a vertex closer than this to the camera plane are not rasterized
+const float NEAR_PLANE = 0.01f;
+
+float edge(const glm::vec2& a, const glm::vec2& b, float px, float py) {
+  return (b.x - a.x) * (py - a.y) - (b.y - a.y) * (px - a.x);
+}
+
+}
+
+Rasterizer::Rasterizer(ThreadPool& pool) : pool(pool) {}
+
+bool Rasterizer::rasterize(const Scene& scene, const Camera& camera, float fov, VisibilityBuffer& buffer) {
+  float aspectRatio = static_cast<float>(buffer.width) / static_cast<float>(buffer.height);
+  float scaleX = aspectRatio * tan(fov/2.0f);
+  float scaleY = tan(fov/2.0f);
+
+  glm::vec3 cameraDir = glm::normalize(camera.target - camera.position);
+  glm::vec3 cameraX = glm::normalize(glm::cross(cameraDir, camera.up));
+  glm::vec3 cameraY = glm::normalize(glm::cross(cameraX, cameraDir));
+
+  // Maps a world position to pixel coordinates, where pixel centers sit at x + 0.5,
+  // using the same projection render() builds its primary rays with
+  auto project = [&](const glm::vec3& point, glm::vec2& screen, float& depth) {
+    glm::vec3 d = point - camera.position;
+    depth = glm::dot(d, cameraDir);
+    if (depth <= NEAR_PLANE) {
+      return false;
+    }
+    screen.x = (glm::dot(d, cameraX) / depth / scaleX + 1.0f) * buffer.width / 2.0f;
+    screen.y = (1.0f - glm::dot(d, cameraY) / depth / scaleY) * buffer.height / 2.0f;
+    return true;
+  };
+
+  triangles.clear();
+  impostors.clear();
+
+  for (int index = 0; index < static_cast<int>(scene.objects.size()); index++) {
+    const Object* object = scene.objects[index];
+
+    if (const Cube* cube = dynamic_cast<const Cube*>(object)) {
+      float half = cube->getSideLength() / 2.0f;
+
+      for (int axis = 0; axis < 3; axis++) {
+        for (int side = 0; side < 2; side++) {
+          float sign = side == 0 ? -1.0f : 1.0f;
+
+          glm::vec3 normal(0.0f);
+          normal[axis] = sign;
+          glm::vec3 faceCenter = cube->getPosition() + normal * half;
+
+          // Faces turned away from the camera are always hidden by the front ones
+          if (glm::dot(normal, faceCenter - camera.position) >= 0) {
+            continue;
+          }
+
+          int u = (axis + 1) % 3;
+          int v = (axis + 2) % 3;
+          const float corners[4][2] = { {-1, -1}, {1, -1}, {1, 1}, {-1, 1} };
+
+          glm::vec2 screen[4];
+          float depth[4];
+          for (int corner = 0; corner < 4; corner++) {
+            glm::vec3 point = faceCenter;
+            point[u] += corners[corner][0] * half;
+            point[v] += corners[corner][1] * half;
+            if (!project(point, screen[corner], depth[corner])) {
+              return false;
+            }
+          }
+
+          int primitive = index * FACES_PER_OBJECT + axis * 2 + side;
+          triangles.push_back(ScreenTriangle{{screen[0], screen[1], screen[2]}, {1.0f / depth[0], 1.0f / depth[1], 1.0f / depth[2]}, primitive});
+          triangles.push_back(ScreenTriangle{{screen[0], screen[2], screen[3]}, {1.0f / depth[0], 1.0f / depth[2], 1.0f / depth[3]}, primitive});
+        }
+      }
+    } else if (const Sphere* sphere = dynamic_cast<const Sphere*>(object)) {
+      // Screen bounds of the sphere's bounding box; the impostor is exact inside them
+      float radius = sphere->getRadius();
+      glm::vec2 minScreen(static_cast<float>(buffer.width), static_cast<float>(buffer.height));
+      glm::vec2 maxScreen(0.0f);
+
+      for (int corner = 0; corner < 8; corner++) {
+        glm::vec3 point = sphere->getCenter() + glm::vec3(
+          corner & 1 ? radius : -radius,
+          corner & 2 ? radius : -radius,
+          corner & 4 ? radius : -radius
+        );
+        glm::vec2 screen;
+        float depth;
+        if (!project(point, screen, depth)) {
+          return false;
+        }
+        minScreen = glm::vec2(std::min(minScreen.x, screen.x), std::min(minScreen.y, screen.y));
+        maxScreen = glm::vec2(std::max(maxScreen.x, screen.x), std::max(maxScreen.y, screen.y));
+      }
+
+      impostors.push_back(SphereImpostor{
+        sphere->getCenter(), radius,
+        static_cast<int>(std::floor(minScreen.x)), static_cast<int>(std::floor(minScreen.y)),
+        static_cast<int>(std::ceil(maxScreen.x)), static_cast<int>(std::ceil(maxScreen.y)),
+        index * FACES_PER_OBJECT
+      });
+    } else {
+      return false;
+    }
+  }
+
+  buffer.primitive.resize(buffer.width * buffer.height);
+  buffer.depth.resize(buffer.width * buffer.height);
+
+  int tasks = (buffer.height + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+  pool.parallelFor(tasks, [&](int task) {
+    int firstRow = task * ROWS_PER_TASK;
+    rasterizeRows(camera, cameraX, cameraY, cameraDir, scaleX, scaleY, buffer, firstRow, std::min(firstRow + ROWS_PER_TASK, buffer.height));
+  });
+
+  return true;
+}
+
+void Rasterizer::rasterizeRows(const Camera& camera, const glm::vec3& cameraX, const glm::vec3& cameraY, const glm::vec3& cameraDir,
+                               float scaleX, float scaleY, VisibilityBuffer& buffer, int firstRow, int lastRow) const {
+  std::fill(buffer.primitive.begin() + firstRow * buffer.width, buffer.primitive.begin() + lastRow * buffer.width, NO_PRIMITIVE);
+  std::fill(buffer.depth.begin() + firstRow * buffer.width, buffer.depth.begin() + lastRow * buffer.width, INFINITY);
+
+  for (const ScreenTriangle& triangle : triangles) {
+    float area = edge(triangle.v[0], triangle.v[1], triangle.v[2].x, triangle.v[2].y);
+    if (area == 0) {
+      continue;
+    }
+
+    float minX = std::min({triangle.v[0].x, triangle.v[1].x, triangle.v[2].x});
+    float maxX = std::max({triangle.v[0].x, triangle.v[1].x, triangle.v[2].x});
+    float minY = std::min({triangle.v[0].y, triangle.v[1].y, triangle.v[2].y});
+    float maxY = std::max({triangle.v[0].y, triangle.v[1].y, triangle.v[2].y});
+
+    int startX = std::max(0, static_cast<int>(std::floor(minX)));
+    int endX = std::min(buffer.width - 1, static_cast<int>(std::ceil(maxX)));
+    int startY = std::max(firstRow, static_cast<int>(std::floor(minY)));
+    int endY = std::min(lastRow - 1, static_cast<int>(std::ceil(maxY)));
+
+    for (int y = startY; y <= endY; y++) {
+      float py = y + 0.5f;
+      for (int x = startX; x <= endX; x++) {
+        float px = x + 0.5f;
+
+        // Barycentrics; dividing by the signed area makes them positive inside for either winding
+        float w0 = edge(triangle.v[1], triangle.v[2], px, py) / area;
+        float w1 = edge(triangle.v[2], triangle.v[0], px, py) / area;
+        float w2 = edge(triangle.v[0], triangle.v[1], px, py) / area;
+        if (w0 < 0 || w1 < 0 || w2 < 0) {
+          continue;
+        }
+
+        // 1/z is linear in screen space, so this is perspective correct
+        float depth = 1.0f / (w0 * triangle.inverseDepth[0] + w1 * triangle.inverseDepth[1] + w2 * triangle.inverseDepth[2]);
+
+        int pixel = y * buffer.width + x;
+        if (depth < buffer.depth[pixel]) {
+          buffer.depth[pixel] = depth;
+          buffer.primitive[pixel] = triangle.primitive;
+        }
+      }
+    }
+  }
+
+  for (const SphereImpostor& impostor : impostors) {
+    int startY = std::max(firstRow, impostor.minY);
+    int endY = std::min(lastRow - 1, impostor.maxY);
+    int startX = std::max(0, impostor.minX);
+    int endX = std::min(buffer.width - 1, impostor.maxX);
+
+    for (int y = startY; y <= endY; y++) {
+      float screenY = (-(2.0f * (y + 0.5f)) / buffer.height + 1.0f) * scaleY;
+      for (int x = startX; x <= endX; x++) {
+        float screenX = ((2.0f * (x + 0.5f)) / buffer.width - 1.0f) * scaleX;
+        glm::vec3 rayDirection = glm::normalize(cameraDir + cameraX * screenX + cameraY * screenY);
+
+        glm::vec3 oc = camera.position - impostor.center;
+        float b = glm::dot(oc, rayDirection);
+        float c = glm::dot(oc, oc) - impostor.radius * impostor.radius;
+        float discriminant = b * b - c;
+        if (discriminant < 0) {
+          continue;
+        }
+        float dist = -b - std::sqrt(discriminant);
+        if (dist < 0) {
+          continue;
+        }
+
+        float depth = dist * glm::dot(rayDirection, cameraDir);
+        int pixel = y * buffer.width + x;
+        if (depth < buffer.depth[pixel]) {
+          buffer.depth[pixel] = depth;
+          buffer.primitive[pixel] = impostor.primitive;
+        }
+      }
+    }
+  }
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <vector>
+#include <glm/glm.hpp>
+#include "camera.h"
+#include "scene.h"
+#include "threadpool.h"
+
+const int NO_PRIMITIVE = -1;
+// Primitive IDs are objectIndex * FACES_PER_OBJECT + face; spheres only use face 0
+const int FACES_PER_OBJECT = 6;
+
+// Nearest primitive under each pixel center and its view-space depth
+struct VisibilityBuffer {
+  int width = 0;
+  int height = 0;
+  std::vector<int> primitive;
+  std::vector<float> depth;
+};
+
+// Rasterizes primary visibility for scenes made of cubes and spheres.
+// Cube faces are drawn as two triangles each, spheres as screen-space
+// impostors that are intersected analytically inside their projected bounds.
+class Rasterizer {
+public:
+  explicit Rasterizer(ThreadPool& pool);
+
+  // Fills buffer for the camera with the same projection the ray tracer uses.
+  // Returns false when the scene can't be rasterized (an unknown object type,
+  // or a primitive crossing the near plane) and primary rays must be traced.
+  bool rasterize(const Scene& scene, const Camera& camera, float fov, VisibilityBuffer& buffer);
+
+private:
+  struct ScreenTriangle {
+    glm::vec2 v[3];
+    float inverseDepth[3];
+    int primitive;
+  };
+
+  struct SphereImpostor {
+    glm::vec3 center;
+    float radius;
+    int minX, minY, maxX, maxY;
+    int primitive;
+  };
+
+  ThreadPool& pool;
+  std::vector<ScreenTriangle> triangles;
+  std::vector<SphereImpostor> impostors;
+
+  void rasterizeRows(const Camera& camera, const glm::vec3& cameraX, const glm::vec3& cameraY, const glm::vec3& cameraDir,
+                     float scaleX, float scaleY, VisibilityBuffer& buffer, int firstRow, int lastRow) const;
+};
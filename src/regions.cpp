@@ -0,0 +1,61 @@
+#include "regions.h"
+#include <algorithm>
+#include <limits>
+
+void RegionDependencies::reset(int objectCount) {
+  objects.assign((objectCount + 63) / 64, 0);
+  lit = false;
+  segments = Bounds{glm::vec3(std::numeric_limits<float>::max()), glm::vec3(std::numeric_limits<float>::lowest())};
+}
+
+void RegionDependencies::addObject(int index) {
+  objects[index / 64] |= uint64_t(1) << (index % 64);
+}
+
+bool RegionDependencies::hasObject(int index) const {
+  return objects[index / 64] & (uint64_t(1) << (index % 64));
+}
+
+void RegionDependencies::addSegment(const Bounds& scene, const glm::vec3& origin, const glm::vec3& direction, float maxDistance) {
+  // Slab test against the scene box; rays leaving it can't hit anything else
+  float tNear = 0.0f;
+  float tFar = maxDistance;
+  for (int axis = 0; axis < 3; axis++) {
+    if (direction[axis] == 0.0f) {
+      if (origin[axis] < scene.min[axis] || origin[axis] > scene.max[axis]) {
+        return;
+      }
+      continue;
+    }
+    float t0 = (scene.min[axis] - origin[axis]) / direction[axis];
+    float t1 = (scene.max[axis] - origin[axis]) / direction[axis];
+    tNear = std::max(tNear, std::min(t0, t1));
+    tFar = std::min(tFar, std::max(t0, t1));
+  }
+  if (tNear > tFar) {
+    return;
+  }
+
+  glm::vec3 enter = origin + direction * tNear;
+  glm::vec3 exit = origin + direction * tFar;
+  segments.min = glm::min(segments.min, glm::min(enter, exit));
+  segments.max = glm::max(segments.max, glm::max(enter, exit));
+}
+
+bool overlaps(const Bounds& a, const Bounds& b) {
+  for (int axis = 0; axis < 3; axis++) {
+    if (a.min[axis] > b.max[axis] || b.min[axis] > a.max[axis]) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool contains(const Bounds& outer, const Bounds& inner) {
+  for (int axis = 0; axis < 3; axis++) {
+    if (inner.min[axis] < outer.min[axis] || inner.max[axis] > outer.max[axis]) {
+      return false;
+    }
+  }
+  return true;
+}
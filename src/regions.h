@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <glm/glm.hpp>
+#include "object.h"
+
+// Side of the square screen regions that are re-rendered on their own after a scene edit
+const int REGION_SIZE = 16;
+
+// What the rays of one screen region depended on when it was last rendered.
+// An edit only needs to re-render the regions whose dependencies it touches.
+struct RegionDependencies {
+  // One bit per object index hit by a primary, shadow or secondary ray
+  std::vector<uint64_t> objects;
+  // Some ray was shaded against the light
+  bool lit = false;
+  // Encloses every shadow and secondary ray segment inside the scene bounds;
+  // an object moved into it may now block one of those rays
+  Bounds segments;
+
+  void reset(int objectCount);
+  void addObject(int index);
+  bool hasObject(int index) const;
+  // Adds the part of the ray from origin up to maxDistance that lies inside scene
+  void addSegment(const Bounds& scene, const glm::vec3& origin, const glm::vec3& direction, float maxDistance);
+};
+
+bool overlaps(const Bounds& a, const Bounds& b);
+bool contains(const Bounds& outer, const Bounds& inner);
@@ -0,0 +1,843 @@
+#include "renderer.h"
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <utility>
+#include <vector>
+#include <glm/gtc/constants.hpp>
+#include "texture.h"
+
+namespace {
+
+// Relative gap between rasterized and exact depth beyond which a hybrid pixel is traced
+const float VISIBILITY_DEPTH_TOLERANCE = 1e-3f;
+
+struct PrimaryHit {
+  int pixel;
+  const Object* object;
+  Intersect intersect;
+  glm::vec3 rayDirection;
+  PathSample path;
+};
+
+glm::vec3 toVec3(const Color& color) {
+  return glm::vec3(color.r, color.g, color.b) / 255.0f;
+}
+
+// Irradiance lattice coordinates are packed into 20 bits each
+const int LATTICE_LIMIT = 1 << 19;
+
+// Samples gathered per irradiance record, stratified in cos^2(theta) and phi
+const int THETA_STRATA = 6;
+const int PHI_STRATA = 12;
+
+bool irradianceKey(int axis, bool positive, int cellU, int cellV, int plane, uint64_t& key) {
+  if (std::abs(cellU) >= LATTICE_LIMIT || std::abs(cellV) >= LATTICE_LIMIT || std::abs(plane) >= LATTICE_LIMIT) {
+    return false;
+  }
+  // The top bit keeps keys away from 0, which marks a free cache slot
+  key = (uint64_t(1) << 63) | (uint64_t(axis) << 61) | (uint64_t(positive) << 60) |
+        (uint64_t(cellU & 0xFFFFF) << 40) | (uint64_t(cellV & 0xFFFFF) << 20) | uint64_t(plane & 0xFFFFF);
+  return true;
+}
+
+// Dependencies of the region the current worker is rendering, if any
+thread_local RegionDependencies* recording = nullptr;
+// Angle covered by one pixel of the view the current worker is rendering,
+// used to size texture footprints of hits
+thread_local float pixelSpread = 0.0f;
+
+}
+
+Renderer::Renderer(const Scene& scene, ThreadPool& pool)
+  : scene(scene), pool(pool), denoiser(pool), rasterizer(pool) {}
+
+float Renderer::castShadow(const glm::vec3& shadowOrigin, const glm::vec3& lightDir, const glm::vec3& lightPosition, const Object* hitObject) const {
+  // Any object along the whole ray can become the occluder after an edit
+  if (recording) {
+    recording->addSegment(sceneBounds, shadowOrigin, lightDir, std::numeric_limits<float>::max());
+  }
+
+  for (int index = 0; index < static_cast<int>(scene.objects.size()); index++) {
+    const Object* obj = scene.objects[index];
+    if (obj != hitObject) {
+      Intersect shadowIntersect = obj->rayIntersect(shadowOrigin, lightDir);
+      if (shadowIntersect.isIntersecting && shadowIntersect.dist > 0) {
+        if (recording) {
+          recording->addObject(index);
+        }
+        float shadowRatio = shadowIntersect.dist / glm::length(lightPosition - shadowOrigin);
+        shadowRatio = glm::min(1.0f, shadowRatio);
+        return 1.0f - shadowRatio;
+      }
+    }
+  }
+  return 1.0f;
+}
+
+Intersect Renderer::traceRay(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, int& hitIndex) const {
+  float zBuffer = 99999;
+  Intersect intersect;
+  hitIndex = SKY_ID;
+
+  for (int index = 0; index < static_cast<int>(scene.objects.size()); index++) {
+    Intersect i = scene.objects[index]->rayIntersect(rayOrigin, rayDirection);
+    if (i.isIntersecting && i.dist < zBuffer) {
+      zBuffer = i.dist;
+      hitIndex = index;
+      intersect = i;
+    }
+  }
+  return intersect;
+}
+
+// Nearest hit in front of the origin. traceRay also accepts the hits behind the
+// origin that Cube reports, which existing images depend on.
+Intersect Renderer::nearestAhead(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, int& hitIndex) const {
+  float zBuffer = std::numeric_limits<float>::max();
+  Intersect intersect;
+  hitIndex = SKY_ID;
+
+  for (int index = 0; index < static_cast<int>(scene.objects.size()); index++) {
+    Intersect i = scene.objects[index]->rayIntersect(rayOrigin, rayDirection);
+    if (i.isIntersecting && i.dist > 0 && i.dist < zBuffer) {
+      zBuffer = i.dist;
+      hitIndex = index;
+      intersect = i;
+    }
+  }
+  return intersect;
+}
+
+Renderer::SceneStamp Renderer::stampScene() const {
+  SceneStamp stamp;
+  stamp.objects.assign(scene.objects.begin(), scene.objects.end());
+  for (const Object* object : scene.objects) {
+    stamp.revisions.push_back(object->revision);
+  }
+  stamp.lightRevision = scene.light.revision;
+  stamp.skyLoaded = scene.skybox->isLoaded();
+  return stamp;
+}
+
+// Gathered irradiance is reused across frames until the scene itself changes
+void Renderer::prepareIndirect(const RenderSettings& settings) {
+  indirectLighting = settings.indirect;
+  if (!settings.indirect) {
+    return;
+  }
+  SceneStamp stamp = stampScene();
+  if (!irradianceCache) {
+    irradianceCache = std::make_unique<IrradianceCache>();
+    irradianceStamp = std::move(stamp);
+  } else if (!(stamp == irradianceStamp)) {
+    irradianceCache->clear();
+    irradianceStamp = std::move(stamp);
+  }
+}
+
+// Indirect irradiance at point, blended from the four records around it on
+// the lattice plane facing the dominant axis of the normal. Each record is
+// extrapolated to the point with its gradient before blending.
+glm::vec3 Renderer::indirectAt(const glm::vec3& point, const glm::vec3& normal) const {
+  glm::vec3 magnitude = glm::abs(normal);
+  int axis = magnitude.x > magnitude.y ? (magnitude.x > magnitude.z ? 0 : 2) : (magnitude.y > magnitude.z ? 1 : 2);
+  bool positive = normal[axis] > 0.0f;
+  int axisU = (axis + 1) % 3;
+  int axisV = (axis + 2) % 3;
+
+  // Records sit on the first lattice plane in front of the surface; the margin
+  // keeps a surface that lies on a lattice plane from flickering between two
+  float planeCoordinate = point[axis] / IRRADIANCE_CELL_SIZE;
+  int plane = static_cast<int>(positive ? std::ceil(planeCoordinate - 0.01f) : std::floor(planeCoordinate + 0.01f));
+
+  float s = point[axisU] / IRRADIANCE_CELL_SIZE - 0.5f;
+  float t = point[axisV] / IRRADIANCE_CELL_SIZE - 0.5f;
+  int cellU = static_cast<int>(std::floor(s));
+  int cellV = static_cast<int>(std::floor(t));
+  float fractionU = s - cellU;
+  float fractionV = t - cellV;
+
+  glm::vec3 sum(0.0f);
+  float weightSum = 0.0f;
+  for (int corner = 0; corner < 4; corner++) {
+    int du = corner & 1;
+    int dv = corner >> 1;
+    float weight = (du ? fractionU : 1.0f - fractionU) * (dv ? fractionV : 1.0f - fractionV);
+    uint64_t key;
+    if (weight <= 0.0f || !irradianceKey(axis, positive, cellU + du, cellV + dv, plane, key)) {
+      continue;
+    }
+
+    glm::vec3 site;
+    site[axis] = plane * IRRADIANCE_CELL_SIZE;
+    site[axisU] = (cellU + du + 0.5f) * IRRADIANCE_CELL_SIZE;
+    site[axisV] = (cellV + dv + 0.5f) * IRRADIANCE_CELL_SIZE;
+
+    IrradianceRecord record = irradianceCache->fetch(key, [&] { return gatherIrradiance(key, site, axis, positive); });
+    if (!record.valid) {
+      continue;
+    }
+    glm::vec3 irradiance = record.irradiance
+      + record.gradientU * (point[axisU] - site[axisU])
+      + record.gradientV * (point[axisV] - site[axisV]);
+    sum = sum + glm::max(irradiance, glm::vec3(0.0f)) * weight;
+    weightSum += weight;
+  }
+  return weightSum > 0.0f ? sum / weightSum : glm::vec3(0.0f);
+}
+
+// Irradiance at a lattice site from stratified cosine-weighted hemisphere
+// samples, each shaded with direct light only. The translational gradient is
+// estimated from the same samples (Ward and Heckbert 1992).
+IrradianceRecord Renderer::gatherIrradiance(uint64_t key, const glm::vec3& site, int axis, bool positive) const {
+  IrradianceRecord record;
+
+  // Sites inside an object would only see its inside
+  for (const Object* object : scene.objects) {
+    Bounds bounds = object->bounds();
+    if (site.x > bounds.min.x && site.y > bounds.min.y && site.z > bounds.min.z &&
+        site.x < bounds.max.x && site.y < bounds.max.y && site.z < bounds.max.z) {
+      return record;
+    }
+  }
+
+  int axisU = (axis + 1) % 3;
+  int axisV = (axis + 2) % 3;
+  glm::vec3 normal(0.0f);
+  normal[axis] = positive ? 1.0f : -1.0f;
+  glm::vec3 tangentU(0.0f);
+  tangentU[axisU] = 1.0f;
+  glm::vec3 tangentV(0.0f);
+  tangentV[axisV] = 1.0f;
+  glm::vec3 origin = site + normal * BIAS;
+
+  // Gather rays belong to the record, not to the screen region that asked for it
+  RegionDependencies* region = recording;
+  recording = nullptr;
+
+  // Jittered by a seed from the key, so records don't all share one pattern
+  Sampler sampler(static_cast<uint32_t>(key ^ (key >> 32)), 0, 0, false);
+  glm::vec2 jitter = sampler.get2D(0, Sampler::PIXEL_DIMENSION);
+
+  glm::vec3 radiance[THETA_STRATA][PHI_STRATA];
+  float distance[THETA_STRATA][PHI_STRATA];
+  for (int j = 0; j < THETA_STRATA; j++) {
+    float sinTheta = std::sqrt((j + jitter.x) / THETA_STRATA);
+    float cosTheta = std::sqrt(1.0f - sinTheta * sinTheta);
+    for (int k = 0; k < PHI_STRATA; k++) {
+      float phi = 2.0f * glm::pi<float>() * (k + jitter.y) / PHI_STRATA;
+      glm::vec3 direction = (tangentU * std::cos(phi) + tangentV * std::sin(phi)) * sinTheta + normal * cosTheta;
+
+      // Shaded as the last diffuse bounce, so gathering never recurses into the cache
+      int hitIndex;
+      Intersect hit = nearestAhead(origin, direction, hitIndex);
+      if (hit.isIntersecting) {
+        const Object* hitObject = scene.objects[hitIndex];
+        PathSample path{sampler, 1 + j * PHI_STRATA + k};
+        radiance[j][k] = toVec3((this->*shadingKernels[hitObject->features])(hit, hitObject, origin, direction, path, MAX_RECURSION - 1));
+        distance[j][k] = hit.dist;
+      } else {
+        // The skybox is a backdrop, not a light source
+        radiance[j][k] = glm::vec3(0.0f);
+        distance[j][k] = std::numeric_limits<float>::max();
+      }
+      record.irradiance = record.irradiance + radiance[j][k];
+    }
+  }
+  record.irradiance = record.irradiance * (glm::pi<float>() / (THETA_STRATA * PHI_STRATA));
+
+  // Change between neighbouring strata, weighted by how far their boundary
+  // moves as the site is moved, which is larger for closer geometry
+  for (int k = 0; k < PHI_STRATA; k++) {
+    int previous = (k + PHI_STRATA - 1) % PHI_STRATA;
+    float phiCenter = 2.0f * glm::pi<float>() * (k + 0.5f) / PHI_STRATA;
+    float phiMinus = 2.0f * glm::pi<float>() * k / PHI_STRATA;
+
+    for (int j = 1; j < THETA_STRATA; j++) {
+      float sinThetaMinus = std::sqrt(static_cast<float>(j) / THETA_STRATA);
+      float cosThetaMinusSquared = 1.0f - static_cast<float>(j) / THETA_STRATA;
+      float scale = (2.0f * glm::pi<float>() / PHI_STRATA) * sinThetaMinus * cosThetaMinusSquared / std::min(distance[j][k], distance[j - 1][k]);
+      glm::vec3 change = (radiance[j][k] - radiance[j - 1][k]) * scale;
+      record.gradientU = record.gradientU + change * std::cos(phiCenter);
+      record.gradientV = record.gradientV + change * std::sin(phiCenter);
+    }
+
+    for (int j = 0; j < THETA_STRATA; j++) {
+      float sinThetaPlus = std::sqrt(static_cast<float>(j + 1) / THETA_STRATA);
+      float sinThetaMinus = std::sqrt(static_cast<float>(j) / THETA_STRATA);
+      float scale = (sinThetaPlus - sinThetaMinus) / std::min(distance[j][k], distance[j][previous]);
+      glm::vec3 change = (radiance[j][k] - radiance[j][previous]) * scale;
+      record.gradientU = record.gradientU - change * std::sin(phiMinus);
+      record.gradientV = record.gradientV + change * std::cos(phiMinus);
+    }
+  }
+
+  // Close occluders make the gradient noisy; over one cell it may at most
+  // double or cancel the gathered value
+  glm::vec3 limit = record.irradiance / IRRADIANCE_CELL_SIZE;
+  record.gradientU = glm::min(glm::max(record.gradientU, limit * -1.0f), limit);
+  record.gradientV = glm::min(glm::max(record.gradientV, limit * -1.0f), limit);
+
+  recording = region;
+  record.valid = true;
+  return record;
+}
+
+// Primary hit from the rasterized visibility buffer. Inside a primitive only
+// that primitive is intersected, to get the exact point and the same normal
+// the tracer would; every other pixel falls back to a traced ray.
+Intersect Renderer::visibleHit(const ViewSetup& view, const glm::vec3& rayDirection, int x, int y, int& hitIndex) const {
+  const VisibilityBuffer& visibility = *view.visibility;
+  int pixel = y * visibility.width + x;
+  int primitive = visibility.primitive[pixel];
+
+  // Silhouettes, face edges and touching objects are where the rasterizer and
+  // the tracer can disagree on the nearest hit, so those pixels are traced
+  bool edge = (x > 0 && visibility.primitive[pixel - 1] != primitive) ||
+              (x + 1 < visibility.width && visibility.primitive[pixel + 1] != primitive) ||
+              (y > 0 && visibility.primitive[pixel - visibility.width] != primitive) ||
+              (y + 1 < visibility.height && visibility.primitive[pixel + visibility.width] != primitive);
+  if (edge) {
+    return traceRay(view.eye, rayDirection, hitIndex);
+  }
+
+  if (primitive == NO_PRIMITIVE) {
+    hitIndex = SKY_ID;
+    return Intersect{};
+  }
+
+  hitIndex = primitive / FACES_PER_OBJECT;
+  Intersect intersect = scene.objects[hitIndex]->rayIntersect(view.eye, rayDirection);
+  // The exact hit must be where the rasterizer saw the primitive, otherwise
+  // another object may be nearer or tied with it
+  float depth = intersect.dist * glm::dot(rayDirection, view.cameraDir);
+  if (!intersect.isIntersecting || std::abs(depth - visibility.depth[pixel]) > VISIBILITY_DEPTH_TOLERANCE * visibility.depth[pixel]) {
+    return traceRay(view.eye, rayDirection, hitIndex);
+  }
+  return intersect;
+}
+
+// Size of the hit's pixel footprint in texture space. Reflected and refracted
+// hits are treated like primary ones at the same distance.
+float Renderer::footprint(const Intersect& intersect) const {
+  return intersect.dist * pixelSpread * intersect.uvScale;
+}
+
+Color Renderer::diffuseAt(const Material& mat, const Intersect& intersect) const {
+  if (!mat.diffuseMap) {
+    return mat.diffuse;
+  }
+  return mat.diffuse * mat.diffuseMap->sample(intersect.uv, footprint(intersect));
+}
+
+// Shading kernel for one feature set; terms the material does not use are compiled out
+template <uint8_t Features>
+Color Renderer::shade(const Intersect& intersect, const Object* hitObject, const glm::vec3& rayOrigin, const glm::vec3& rayDirection, const PathSample& path, const short recursion) const {
+  constexpr bool hasSpecular = Features & MaterialFeature::SPECULAR;
+  constexpr bool hasMirror = Features & MaterialFeature::MIRROR;
+  constexpr bool hasGlass = Features & MaterialFeature::GLASS;
+  constexpr bool hasTextures = Features & MaterialFeature::TEXTURED;
+
+  const Material& mat = hitObject->material;
+  const Light& light = scene.light;
+
+  Color diffuse = mat.diffuse;
+  float specularAlbedo = mat.specularAlbedo;
+  glm::vec3 normal = intersect.normal;
+
+  if constexpr (hasTextures) {
+    diffuse = diffuseAt(mat, intersect);
+    if (mat.specularMap) {
+      specularAlbedo *= mat.specularMap->sample(intersect.uv, footprint(intersect)).r / 255.0f;
+    }
+    if (mat.normalMap) {
+      Color texel = mat.normalMap->sample(intersect.uv, footprint(intersect));
+      glm::vec3 tangentNormal = glm::vec3(texel.r, texel.g, texel.b) / 127.5f - glm::vec3(1.0f);
+      glm::vec3 bitangent = glm::cross(normal, intersect.tangent);
+      normal = glm::normalize(intersect.tangent * tangentNormal.x + bitangent * tangentNormal.y + normal * tangentNormal.z);
+    }
+  }
+
+  int bounceDimension = Sampler::FIRST_BOUNCE_DIMENSION + recursion * Sampler::DIMENSIONS_PER_BOUNCE;
+
+  // Area lights are sampled at one point of their disk per path, which softens shadow edges
+  glm::vec3 lightPosition = light.position;
+  if (light.radius > 0) {
+    glm::vec3 towardsHit = glm::normalize(intersect.point - light.position);
+    lightPosition = sampleDisk(light.position, towardsHit, light.radius, path.sampler.get2D(path.index, bounceDimension));
+  }
+
+  glm::vec3 lightDir = glm::normalize(lightPosition - intersect.point);
+  float shadowIntensity = castShadow(intersect.point, lightDir, lightPosition, hitObject);
+  float diffuseLightIntensity = std::max(0.0f, glm::dot(normal, lightDir));
+
+  Color color = diffuse * light.intensity * diffuseLightIntensity * mat.albedo * shadowIntensity;
+
+  // Bounced light is gathered for camera and first reflection hits; the
+  // gather rays themselves end on direct light
+  if (indirectLighting && recursion < MAX_RECURSION - 1) {
+    glm::vec3 indirect = glm::min(indirectAt(intersect.point, intersect.normal) * (mat.albedo / glm::pi<float>()), glm::vec3(1.0f));
+    color = color + diffuse * Color(indirect.r, indirect.g, indirect.b);
+  }
+
+  if constexpr (hasSpecular || hasMirror) {
+    glm::vec3 reflectDir = glm::reflect(-lightDir, normal);
+
+    if constexpr (hasSpecular) {
+      glm::vec3 viewDir = glm::normalize(rayOrigin - intersect.point);
+      float specLightIntensity = std::pow(std::max(0.0f, glm::dot(viewDir, reflectDir)), mat.specularCoefficient);
+      Color specularLight = light.color * light.intensity * specLightIntensity * specularAlbedo * shadowIntensity;
+      color = color + specularLight;
+    }
+
+    if constexpr (hasMirror || hasGlass) {
+      color = color * (1.0f - mat.reflectivity - mat.transparency);
+    }
+
+    if constexpr (hasMirror) {
+      glm::vec3 origin = intersect.point + normal * BIAS;
+      glm::vec3 mirrorDir = reflectDir;
+      if (mat.roughness > 0) {
+        mirrorDir = sampleCone(reflectDir, mat.roughness, path.sampler.get2D(path.index, bounceDimension + 2));
+      }
+      Color reflectedColor = castRay(origin, mirrorDir, path, recursion + 1);
+      color = color + reflectedColor * mat.reflectivity;
+    }
+  } else if constexpr (hasGlass) {
+    color = color * (1.0f - mat.reflectivity - mat.transparency);
+  }
+
+  if constexpr (hasGlass) {
+    glm::vec3 origin = intersect.point - normal * BIAS;
+    glm::vec3 refractDir = glm::refract(rayDirection, normal, mat.refractionIndex);
+    Color refractedColor = castRay(origin, refractDir, path, recursion + 1);
+    color = color + refractedColor * mat.transparency;
+  }
+
+  return color;
+}
+
+const std::array<Renderer::ShadingKernel, SHADING_KERNEL_COUNT> Renderer::shadingKernels =
+  []<size_t... Features>(std::index_sequence<Features...>) {
+    return std::array<ShadingKernel, sizeof...(Features)>{ &Renderer::shade<Features>... };
+  }(std::make_index_sequence<SHADING_KERNEL_COUNT>{});
+
+Color Renderer::castRay(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, const PathSample& path, const short recursion) const {
+  int hitIndex;
+  Intersect intersect = traceRay(rayOrigin, rayDirection, hitIndex);
+
+  // The last bounce shows the sky whatever it hits, so it depends on nothing
+  if (recording && recursion < MAX_RECURSION) {
+    float maxDistance = intersect.isIntersecting ? intersect.dist : std::numeric_limits<float>::max();
+    recording->addSegment(sceneBounds, rayOrigin, rayDirection, maxDistance);
+    if (intersect.isIntersecting) {
+      recording->addObject(hitIndex);
+      recording->lit = true;
+    }
+  }
+
+  if (!intersect.isIntersecting || recursion == MAX_RECURSION) {
+    glm::vec3 skyboxColor = scene.skybox->getColor(rayDirection);
+    return Color(skyboxColor.r, skyboxColor.g, skyboxColor.b);
+  }
+
+  const Object* hitObject = scene.objects[hitIndex];
+  return (this->*shadingKernels[hitObject->features])(intersect, hitObject, rayOrigin, rayDirection, path, recursion);
+}
+
+glm::vec3 Renderer::ViewSetup::primaryDirection(float x, float y) const {
+  if (projection == Projection::EQUIRECTANGULAR) {
+    float longitude = (2.0f * x / buffer->width - 1.0f) * glm::pi<float>();
+    float latitude = (0.5f - y / buffer->height) * glm::pi<float>();
+    return glm::normalize(
+      (cameraDir * std::cos(longitude) + cameraX * std::sin(longitude)) * std::cos(latitude) + cameraY * std::sin(latitude)
+    );
+  }
+
+  float screenX = (2.0f * x) / buffer->width - 1.0f;
+  float screenY = -(2.0f * y) / buffer->height + 1.0f;
+  screenX *= aspectRatio;
+  screenX *= tan(FOV/2.0f);
+  screenY *= tan(FOV/2.0f);
+
+  return glm::normalize(
+    cameraDir + cameraX * screenX + cameraY * screenY
+  );
+}
+
+Renderer::ViewSetup Renderer::setUpView(const Camera& camera, Projection projection, GBuffer& target) const {
+  ViewSetup view;
+  view.eye = camera.position;
+  view.projection = projection;
+  view.cameraDir = glm::normalize(camera.target - camera.position);
+  view.cameraX = glm::normalize(glm::cross(view.cameraDir, camera.up));
+  view.cameraY = glm::normalize(glm::cross(view.cameraX, view.cameraDir));
+  view.aspectRatio = static_cast<float>(target.width) / static_cast<float>(target.height);
+  view.pixelSpread = projection == Projection::EQUIRECTANGULAR
+    ? 2.0f * glm::pi<float>() / target.width
+    : 2.0f * tan(FOV/2.0f) / target.height;
+  view.buffer = &target;
+  view.regionsX = (target.width + REGION_SIZE - 1) / REGION_SIZE;
+  return view;
+}
+
+void Renderer::renderRegion(const ViewSetup& view, const RenderSettings& settings, int samplesPerPixel, int region) {
+  // Primary hits bucketed by shading kernel; kept per worker to reuse the storage
+  thread_local std::array<std::vector<PrimaryHit>, SHADING_KERNEL_COUNT> hitsByKernel;
+
+  for (auto& hits : hitsByKernel) {
+    hits.clear();
+  }
+
+  GBuffer& buffer = *view.buffer;
+  int firstX = (region % view.regionsX) * REGION_SIZE;
+  int firstY = (region / view.regionsX) * REGION_SIZE;
+  int lastX = std::min(firstX + REGION_SIZE, buffer.width);
+  int lastY = std::min(firstY + REGION_SIZE, buffer.height);
+
+  RegionDependencies* dependencies = view.regions ? &view.regions[region] : nullptr;
+  if (dependencies) {
+    dependencies->reset(static_cast<int>(scene.objects.size()));
+  }
+  recording = dependencies;
+  pixelSpread = view.pixelSpread;
+
+  float sampleWeight = 1.0f / samplesPerPixel;
+
+  // Trace primary visibility first and group the hits by kernel, so each
+  // kernel then runs over a contiguous batch instead of branching per pixel
+  for (int y = firstY; y < lastY; y++) {
+    for (int x = firstX; x < lastX; x++) {
+      int pixel = y * buffer.width + x;
+      buffer.color[pixel] = glm::vec3(0.0f);
+      Sampler sampler(settings.seed, x, y, settings.blueNoise);
+
+      for (int sample = 0; sample < samplesPerPixel; sample++) {
+        // A single sample stays at the pixel center so the image is stable
+        glm::vec2 offset = samplesPerPixel == 1 ? glm::vec2(0.5f) : sampler.get2D(sample, Sampler::PIXEL_DIMENSION);
+        glm::vec3 rayDirection = view.primaryDirection(x + offset.x, y + offset.y);
+
+        int hitIndex;
+        Intersect intersect = view.visibility
+          ? visibleHit(view, rayDirection, x, y, hitIndex)
+          : traceRay(view.eye, rayDirection, hitIndex);
+
+        // The auxiliary buffers describe the first sample's primary hit
+        if (sample == 0) {
+          buffer.objectId[pixel] = hitIndex;
+          buffer.depth[pixel] = intersect.isIntersecting ? intersect.dist : SKY_DEPTH;
+          buffer.normal[pixel] = intersect.isIntersecting ? intersect.normal : glm::vec3(0.0f);
+        }
+
+        if (!intersect.isIntersecting) {
+          glm::vec3 skyboxColor = scene.skybox->getColor(rayDirection);
+          buffer.color[pixel] += toVec3(Color(skyboxColor.r, skyboxColor.g, skyboxColor.b)) * sampleWeight;
+          if (sample == 0) {
+            buffer.albedo[pixel] = skyboxColor;
+          }
+          continue;
+        }
+
+        const Object* hitObject = scene.objects[hitIndex];
+        if (dependencies) {
+          dependencies->addObject(hitIndex);
+          dependencies->lit = true;
+        }
+        if (sample == 0) {
+          buffer.albedo[pixel] = toVec3(diffuseAt(hitObject->material, intersect));
+        }
+        hitsByKernel[hitObject->features].push_back(PrimaryHit{pixel, hitObject, intersect, rayDirection, PathSample{sampler, sample}});
+      }
+    }
+  }
+
+  for (int kernel = 0; kernel < SHADING_KERNEL_COUNT; kernel++) {
+    for (const PrimaryHit& hit : hitsByKernel[kernel]) {
+      Color color = (this->*shadingKernels[kernel])(hit.intersect, hit.object, view.eye, hit.rayDirection, hit.path, 0);
+      buffer.color[hit.pixel] += toVec3(color) * sampleWeight;
+    }
+  }
+
+  recording = nullptr;
+}
+
+void Renderer::resolveRows(const GBuffer& buffer, Framebuffer& frame, int firstRow, int lastRow) const {
+  for (int y = firstRow; y < lastRow; y++) {
+    for (int x = 0; x < frame.width; x++) {
+      glm::vec3 color = buffer.color[y * buffer.width + x] * 255.0f;
+      frame.at(x, y) = Color(
+        static_cast<int>(std::lround(color.r)),
+        static_cast<int>(std::lround(color.g)),
+        static_cast<int>(std::lround(color.b))
+      );
+    }
+  }
+}
+
+// Marks the regions whose primary rays can see the box
+void Renderer::markProjectedRegions(const Camera& camera, const Bounds& bounds) {
+  float aspectRatio = static_cast<float>(buffer.width) / static_cast<float>(buffer.height);
+  float scale = tan(FOV/2.0f);
+  glm::vec3 cameraDir = glm::normalize(camera.target - camera.position);
+  glm::vec3 cameraX = glm::normalize(glm::cross(cameraDir, camera.up));
+  glm::vec3 cameraY = glm::normalize(glm::cross(cameraX, cameraDir));
+
+  // The box projects inside the screen rectangle of its corners, unless
+  // part of it is behind the camera
+  float minX = std::numeric_limits<float>::max();
+  float minY = std::numeric_limits<float>::max();
+  float maxX = std::numeric_limits<float>::lowest();
+  float maxY = std::numeric_limits<float>::lowest();
+  for (int corner = 0; corner < 8; corner++) {
+    glm::vec3 point(
+      corner & 1 ? bounds.max.x : bounds.min.x,
+      corner & 2 ? bounds.max.y : bounds.min.y,
+      corner & 4 ? bounds.max.z : bounds.min.z
+    );
+    glm::vec3 toPoint = point - camera.position;
+    float depth = glm::dot(toPoint, cameraDir);
+    if (depth <= 0.0f) {
+      std::fill(regionDirty.begin(), regionDirty.end(), 1);
+      return;
+    }
+    float x = (glm::dot(toPoint, cameraX) / (depth * aspectRatio * scale) + 1.0f) * 0.5f * buffer.width;
+    float y = (1.0f - glm::dot(toPoint, cameraY) / (depth * scale)) * 0.5f * buffer.height;
+    minX = std::min(minX, x);
+    minY = std::min(minY, y);
+    maxX = std::max(maxX, x);
+    maxY = std::max(maxY, y);
+  }
+
+  // One pixel of slack for samples spread over the pixel area
+  int firstX = std::max(0, static_cast<int>(std::floor(minX)) - 1);
+  int firstY = std::max(0, static_cast<int>(std::floor(minY)) - 1);
+  int lastX = std::min(buffer.width - 1, static_cast<int>(std::floor(maxX)) + 1);
+  int lastY = std::min(buffer.height - 1, static_cast<int>(std::floor(maxY)) + 1);
+
+  for (int regionY = firstY / REGION_SIZE; firstY <= lastY && regionY <= lastY / REGION_SIZE; regionY++) {
+    for (int regionX = firstX / REGION_SIZE; firstX <= lastX && regionX <= lastX / REGION_SIZE; regionX++) {
+      regionDirty[regionY * regionsX + regionX] = 1;
+    }
+  }
+}
+
+// Compares the scene, camera and settings to what the regions were rendered
+// for and flags the regions that have to be retraced
+void Renderer::markDirtyRegions(const Camera& camera, const RenderSettings& settings) {
+  int objectCount = static_cast<int>(scene.objects.size());
+  bool skyLoaded = scene.skybox->isLoaded();
+
+  bool sameView = history.valid &&
+    camera.position == history.eye && camera.target == history.target && camera.up == history.up &&
+    settings == history.settings && skyLoaded == history.skyLoaded &&
+    objectCount == static_cast<int>(history.objects.size());
+
+  // Objects edited in place; one that leaves the scene bounds may block rays
+  // that were only recorded up to those bounds, so it forces a full frame
+  std::vector<int> edited;
+  for (int index = 0; sameView && index < objectCount; index++) {
+    const Object* object = scene.objects[index];
+    if (object != history.objects[index] || (object->revision != history.revisions[index] && !contains(sceneBounds, object->bounds()))) {
+      sameView = false;
+    } else if (object->revision != history.revisions[index]) {
+      edited.push_back(index);
+    }
+  }
+  // Bounced light carries any edit to the whole frame. The denoiser overwrites
+  // the traced colors, so a filtered frame can only be kept as a whole.
+  bool relit = scene.light.revision != history.lightRevision;
+  if (sameView && (settings.indirect || settings.denoise) && (!edited.empty() || relit)) {
+    sameView = false;
+  }
+  if (sameView && settings.denoise && !frameFinished) {
+    sameView = false;
+  }
+
+  if (!sameView) {
+    std::fill(regionDirty.begin(), regionDirty.end(), 1);
+
+    sceneBounds = Bounds{glm::vec3(0.0f), glm::vec3(0.0f)};
+    for (int index = 0; index < objectCount; index++) {
+      Bounds bounds = scene.objects[index]->bounds();
+      sceneBounds.min = index == 0 ? bounds.min : glm::min(sceneBounds.min, bounds.min);
+      sceneBounds.max = index == 0 ? bounds.max : glm::max(sceneBounds.max, bounds.max);
+    }
+  } else {
+    for (int region = 0; region < static_cast<int>(regions.size()); region++) {
+      const RegionDependencies& dependencies = regions[region];
+      bool dirty = regionDirty[region] || (relit && dependencies.lit);
+      for (int i = 0; !dirty && i < static_cast<int>(edited.size()); i++) {
+        // Either a ray hit the object before the edit or one may hit it now
+        dirty = dependencies.hasObject(edited[i]) || overlaps(dependencies.segments, scene.objects[edited[i]]->bounds());
+      }
+      regionDirty[region] = dirty;
+    }
+
+    for (int index : edited) {
+      markProjectedRegions(camera, scene.objects[index]->bounds());
+    }
+  }
+
+  history.valid = true;
+  history.eye = camera.position;
+  history.target = camera.target;
+  history.up = camera.up;
+  history.settings = settings;
+  history.skyLoaded = skyLoaded;
+  history.objects.assign(scene.objects.begin(), scene.objects.end());
+  history.revisions.resize(objectCount);
+  for (int index = 0; index < objectCount; index++) {
+    history.revisions[index] = scene.objects[index]->revision;
+  }
+  history.lightRevision = scene.light.revision;
+}
+
+bool Renderer::render(const Camera& camera, const RenderSettings& settings, Framebuffer& frame, const std::atomic<bool>& cancel) {
+  if (buffer.width != frame.width || buffer.height != frame.height) {
+    buffer.resize(frame.width, frame.height);
+    regionsX = (frame.width + REGION_SIZE - 1) / REGION_SIZE;
+    regionsY = (frame.height + REGION_SIZE - 1) / REGION_SIZE;
+    regions.assign(regionsX * regionsY, RegionDependencies{});
+    regionDirty.assign(regionsX * regionsY, 1);
+    history.valid = false;
+  }
+
+  int tasks = (frame.height + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+  int samplesPerPixel = std::max(1, settings.samplesPerPixel);
+
+  prepareIndirect(settings);
+  markDirtyRegions(camera, settings);
+  std::vector<int> dirtyRegions;
+  for (int region = 0; region < static_cast<int>(regionDirty.size()); region++) {
+    if (regionDirty[region]) {
+      dirtyRegions.push_back(region);
+    }
+  }
+  // Counted since the last finished frame, so regions of a cancelled one still count as changes
+  if (frameFinished) {
+    renderedRegions = 0;
+    if (dirtyRegions.empty() && &frame == resolvedFrame) {
+      return true;
+    }
+  }
+  renderedRegions += static_cast<int>(dirtyRegions.size());
+  frameFinished = false;
+
+  ViewSetup view = setUpView(camera, Projection::PERSPECTIVE, buffer);
+  view.regions = regions.data();
+  // The visibility buffer only covers pixel centers, so it serves single-sample frames
+  if (settings.hybrid && samplesPerPixel == 1 && !dirtyRegions.empty()) {
+    visibility.width = frame.width;
+    visibility.height = frame.height;
+    if (rasterizer.rasterize(scene, camera, FOV, visibility)) {
+      view.visibility = &visibility;
+    }
+  }
+
+  pool.parallelFor(static_cast<int>(dirtyRegions.size()), [&](int task) {
+    // Once cancelled the remaining regions are skipped and stay dirty for the next frame
+    if (cancel.load(std::memory_order_relaxed)) {
+      return;
+    }
+    renderRegion(view, settings, samplesPerPixel, dirtyRegions[task]);
+    regionDirty[dirtyRegions[task]] = 0;
+  });
+
+  if (cancel.load()) {
+    return false;
+  }
+
+  // Without retraced regions the buffer already holds the filtered frame
+  if (settings.denoise && !dirtyRegions.empty() && !denoiser.denoise(buffer, cancel)) {
+    return false;
+  }
+
+  // Resolved in full, frame is not necessarily the one resolved last time
+  pool.parallelFor(tasks, [&](int task) {
+    int firstRow = task * ROWS_PER_TASK;
+    resolveRows(buffer, frame, firstRow, std::min(firstRow + ROWS_PER_TASK, frame.height));
+  });
+
+  frameFinished = true;
+  resolvedFrame = &frame;
+  return true;
+}
+
+bool Renderer::renderBatch(const std::vector<View>& views, const RenderSettings& settings, const std::atomic<bool>& cancel) {
+  int viewCount = static_cast<int>(views.size());
+  int samplesPerPixel = std::max(1, settings.samplesPerPixel);
+  prepareIndirect(settings);
+  batchBuffers.resize(viewCount);
+  batchVisibility.resize(viewCount);
+
+  // Per-view setup is done once here, not per region
+  std::vector<ViewSetup> setups;
+  setups.reserve(viewCount);
+  for (int index = 0; index < viewCount; index++) {
+    const View& view = views[index];
+    GBuffer& target = batchBuffers[index];
+    if (target.width != view.frame->width || target.height != view.frame->height) {
+      target.resize(view.frame->width, view.frame->height);
+    }
+    setups.push_back(setUpView(view.camera, view.projection, target));
+
+    VisibilityBuffer& visible = batchVisibility[index];
+    if (settings.hybrid && samplesPerPixel == 1 && view.projection == Projection::PERSPECTIVE) {
+      visible.width = target.width;
+      visible.height = target.height;
+      if (rasterizer.rasterize(scene, view.camera, FOV, visible)) {
+        setups.back().visibility = &visible;
+      }
+    }
+  }
+
+  // Regions are dealt round-robin across the views, so every view is in
+  // flight at once and no core idles at the end of one view waiting for the next
+  std::vector<std::pair<int, int>> tasks;
+  for (int region = 0, added = 1; added; region++) {
+    added = 0;
+    for (int index = 0; index < viewCount; index++) {
+      const GBuffer& target = batchBuffers[index];
+      int regionCount = setups[index].regionsX * ((target.height + REGION_SIZE - 1) / REGION_SIZE);
+      if (region < regionCount) {
+        tasks.emplace_back(index, region);
+        added++;
+      }
+    }
+  }
+
+  pool.parallelFor(static_cast<int>(tasks.size()), [&](int task) {
+    if (cancel.load(std::memory_order_relaxed)) {
+      return;
+    }
+    renderRegion(setups[tasks[task].first], settings, samplesPerPixel, tasks[task].second);
+  });
+
+  if (cancel.load()) {
+    return false;
+  }
+
+  for (int index = 0; index < viewCount; index++) {
+    Framebuffer& frame = *views[index].frame;
+    int rowTasks = (frame.height + ROWS_PER_TASK - 1) / ROWS_PER_TASK;
+    pool.parallelFor(rowTasks, [&](int task) {
+      int firstRow = task * ROWS_PER_TASK;
+      resolveRows(batchBuffers[index], frame, firstRow, std::min(firstRow + ROWS_PER_TASK, frame.height));
+    });
+  }
+  return true;
+}
+
+std::vector<View> stereoViews(const Camera& camera, float eyeSeparation, Framebuffer& left, Framebuffer& right) {
+  glm::vec3 cameraDir = glm::normalize(camera.target - camera.position);
+  glm::vec3 offset = glm::normalize(glm::cross(cameraDir, camera.up)) * (eyeSeparation / 2.0f);
+
+  Camera leftEye = camera;
+  leftEye.position -= offset;
+  leftEye.target -= offset;
+  Camera rightEye = camera;
+  rightEye.position += offset;
+  rightEye.target += offset;
+  return {View{leftEye, Projection::PERSPECTIVE, &left}, View{rightEye, Projection::PERSPECTIVE, &right}};
+}
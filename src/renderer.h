@@ -0,0 +1,189 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include <glm/glm.hpp>
+#include "camera.h"
+#include "color.h"
+#include "denoiser.h"
+#include "framebuffer.h"
+#include "gbuffer.h"
+#include "intersect.h"
+#include "irradiance.h"
+#include "object.h"
+#include "rasterizer.h"
+#include "regions.h"
+#include "sampler.h"
+#include "scene.h"
+#include "shading.h"
+#include "threadpool.h"
+
+const int MAX_RECURSION = 3;
+const float BIAS = 0.0001f;
+const float FOV = 3.1415 / 3;
+
+struct RenderSettings {
+  int samplesPerPixel = 1;
+  // Only worth it at low sample counts; filters the traced color using the G-buffer
+  bool denoise = false;
+  // Rasterize primary visibility and only trace shadows, reflections and
+  // refractions. Applies to single-sample frames, more samples are traced.
+  bool hybrid = true;
+  // Seeds every sample of the frame; the same seed renders the same image
+  uint32_t seed = 0;
+  // Decorrelate pixels with a blue-noise mask instead of per-pixel scrambling
+  bool blueNoise = true;
+  // Add diffuse light bounced off other surfaces, from the irradiance cache
+  bool indirect = false;
+
+  bool operator==(const RenderSettings&) const = default;
+};
+
+enum class Projection {
+  PERSPECTIVE,
+  // Full 360 by 180 degree panorama around the camera, longitude along x
+  EQUIRECTANGULAR
+};
+
+// One viewpoint of a batch and the frame it is rendered into
+struct View {
+  Camera camera;
+  Projection projection;
+  Framebuffer* frame;
+};
+
+// Where a path draws its sample values from
+struct PathSample {
+  Sampler sampler;
+  int index;
+};
+
+class Renderer {
+public:
+  Renderer(const Scene& scene, ThreadPool& pool);
+
+  // Renders a whole frame on the pool. Returns false if cancel was raised
+  // before the frame was finished, in which case its content is incomplete.
+  // When nothing changed and frame is the one finished last, it is left as is.
+  bool render(const Camera& camera, const RenderSettings& settings, Framebuffer& frame, const std::atomic<bool>& cancel);
+
+  // Renders every view as one job on the pool, with the regions of all views
+  // interleaved. Views are traced in full, without dirty-region tracking or
+  // denoising. Returns false if cancel was raised before all were finished.
+  bool renderBatch(const std::vector<View>& views, const RenderSettings& settings, const std::atomic<bool>& cancel);
+
+  // Color and auxiliary buffers of the last frame rendered
+  const GBuffer& gbuffer() const { return buffer; }
+
+  // Screen regions retraced for the last frame, 0 when nothing had changed
+  int regionsRendered() const { return renderedRegions; }
+
+  Color castRay(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, const PathSample& path, const short recursion = 0) const;
+
+private:
+  const Scene& scene;
+  ThreadPool& pool;
+  GBuffer buffer;
+  Denoiser denoiser;
+  Rasterizer rasterizer;
+  VisibilityBuffer visibility;
+
+  // Dirty-region tracking. Each region remembers what its rays touched, so
+  // after an object or light edit only the regions it can affect are retraced.
+  int regionsX = 0;
+  int regionsY = 0;
+  std::vector<RegionDependencies> regions;
+  std::vector<char> regionDirty;
+  int renderedRegions = 0;
+  bool frameFinished = true;
+  // Framebuffer the last finished frame was resolved into
+  const Framebuffer* resolvedFrame = nullptr;
+  // Secondary and shadow rays are recorded up to here
+  Bounds sceneBounds{};
+
+  // What the regions were last rendered for
+  struct History {
+    bool valid = false;
+    glm::vec3 eye;
+    glm::vec3 target;
+    glm::vec3 up;
+    RenderSettings settings;
+    bool skyLoaded = false;
+    std::vector<const Object*> objects;
+    std::vector<unsigned> revisions;
+    unsigned lightRevision = 0;
+  };
+  History history;
+
+  // Scene state the irradiance cache was filled in; it is emptied on any edit
+  struct SceneStamp {
+    std::vector<const Object*> objects;
+    std::vector<unsigned> revisions;
+    unsigned lightRevision = 0;
+    bool skyLoaded = false;
+
+    bool operator==(const SceneStamp&) const = default;
+  };
+  // Large, so allocated on the first indirect frame; filled from const shading
+  std::unique_ptr<IrradianceCache> irradianceCache;
+  SceneStamp irradianceStamp;
+  bool indirectLighting = false;
+
+  // Buffers of renderBatch, one per view, kept between batches
+  std::vector<GBuffer> batchBuffers;
+  std::vector<VisibilityBuffer> batchVisibility;
+
+  // What every region of a view needs to generate its primary rays and
+  // store their results, worked out once per frame
+  struct ViewSetup {
+    glm::vec3 eye;
+    Projection projection;
+    glm::vec3 cameraDir;
+    glm::vec3 cameraX;
+    glm::vec3 cameraY;
+    float aspectRatio;
+    float pixelSpread;
+    GBuffer* buffer;
+    int regionsX;
+    // Rasterized primary visibility, null when primary rays are traced
+    const VisibilityBuffer* visibility = nullptr;
+    // Where regions record their dependencies, null when they are not tracked
+    RegionDependencies* regions = nullptr;
+
+    glm::vec3 primaryDirection(float x, float y) const;
+  };
+
+  using ShadingKernel = Color (Renderer::*)(const Intersect&, const Object*, const glm::vec3&, const glm::vec3&, const PathSample&, const short) const;
+
+  // Indexed by Object::features
+  static const std::array<ShadingKernel, SHADING_KERNEL_COUNT> shadingKernels;
+
+  float castShadow(const glm::vec3& shadowOrigin, const glm::vec3& lightDir, const glm::vec3& lightPosition, const Object* hitObject) const;
+  Intersect traceRay(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, int& hitIndex) const;
+  Intersect visibleHit(const ViewSetup& view, const glm::vec3& rayDirection, int x, int y, int& hitIndex) const;
+
+  Intersect nearestAhead(const glm::vec3& rayOrigin, const glm::vec3& rayDirection, int& hitIndex) const;
+
+  SceneStamp stampScene() const;
+  void prepareIndirect(const RenderSettings& settings);
+  glm::vec3 indirectAt(const glm::vec3& point, const glm::vec3& normal) const;
+  IrradianceRecord gatherIrradiance(uint64_t key, const glm::vec3& site, int axis, bool positive) const;
+
+  float footprint(const Intersect& intersect) const;
+  Color diffuseAt(const Material& mat, const Intersect& intersect) const;
+
+  template <uint8_t Features>
+  Color shade(const Intersect& intersect, const Object* hitObject, const glm::vec3& rayOrigin, const glm::vec3& rayDirection, const PathSample& path, const short recursion) const;
+
+  void markDirtyRegions(const Camera& camera, const RenderSettings& settings);
+  void markProjectedRegions(const Camera& camera, const Bounds& bounds);
+  ViewSetup setUpView(const Camera& camera, Projection projection, GBuffer& target) const;
+  void renderRegion(const ViewSetup& view, const RenderSettings& settings, int samplesPerPixel, int region);
+  void resolveRows(const GBuffer& buffer, Framebuffer& frame, int firstRow, int lastRow) const;
+};
+
+// Left and right eye views with parallel axes, eyeSeparation apart
+std::vector<View> stereoViews(const Camera& camera, float eyeSeparation, Framebuffer& left, Framebuffer& right);
@@ -0,0 +1,129 @@
+#include "replay.h"
+#include <cstdio>
+#include <sstream>
+#include <print.h>
+
+InputRecorder::InputRecorder(const std::string& file) : out(file) {
+  out.precision(9);
+}
+
+void InputRecorder::record(const InputEvent& event) {
+  const Camera& camera = event.camera;
+  const RenderSettings& settings = event.settings;
+  out << event.time << ' ' << event.key << ' '
+      << camera.position.x << ' ' << camera.position.y << ' ' << camera.position.z << ' '
+      << camera.target.x << ' ' << camera.target.y << ' ' << camera.target.z << ' '
+      << camera.up.x << ' ' << camera.up.y << ' ' << camera.up.z << ' '
+      << camera.rotationSpeed << ' '
+      << event.lightPosition.x << ' ' << event.lightPosition.y << ' ' << event.lightPosition.z << ' '
+      << settings.samplesPerPixel << ' ' << settings.denoise << ' ' << settings.hybrid << ' '
+      << settings.seed << ' ' << settings.blueNoise << ' ' << settings.indirect << '\n';
+  // Flushed per event so the log survives the session crashing
+  out.flush();
+}
+
+bool loadRecording(const std::string& file, std::vector<InputEvent>& events) {
+  std::ifstream in(file);
+  if (!in) {
+    return false;
+  }
+
+  std::string line;
+  while (std::getline(in, line)) {
+    if (line.empty()) {
+      continue;
+    }
+    std::istringstream fields(line);
+    uint32_t time;
+    SDL_Keycode key;
+    glm::vec3 position, target, up, lightPosition;
+    float rotationSpeed;
+    RenderSettings settings;
+    fields >> time >> key
+           >> position.x >> position.y >> position.z
+           >> target.x >> target.y >> target.z
+           >> up.x >> up.y >> up.z
+           >> rotationSpeed
+           >> lightPosition.x >> lightPosition.y >> lightPosition.z
+           >> settings.samplesPerPixel >> settings.denoise >> settings.hybrid
+           >> settings.seed >> settings.blueNoise;
+    if (!fields) {
+      return false;
+    }
+    // Logs recorded before indirect lighting existed end here
+    if (!(fields >> settings.indirect)) {
+      settings.indirect = false;
+    }
+    events.push_back(InputEvent{time, key, Camera(position, target, up, rotationSpeed), lightPosition, settings});
+  }
+  return true;
+}
+
+uint64_t frameChecksum(const Framebuffer& frame) {
+  uint64_t hash = 14695981039346656037ull;
+  for (const Color& pixel : frame.pixels) {
+    for (uint8_t channel : {pixel.r, pixel.g, pixel.b}) {
+      hash = (hash ^ channel) * 1099511628211ull;
+    }
+  }
+  return hash;
+}
+
+bool saveTimings(const std::vector<FrameTiming>& timings, const std::string& file) {
+  std::ofstream out(file);
+  out << "frame,key,milliseconds,checksum\n";
+  for (const FrameTiming& timing : timings) {
+    char checksum[17];
+    std::snprintf(checksum, sizeof(checksum), "%016llx", static_cast<unsigned long long>(timing.checksum));
+    out << timing.frame << ',' << timing.key << ',' << timing.milliseconds << ',' << checksum << '\n';
+  }
+  return bool(out);
+}
+
+bool loadTimings(const std::string& file, std::vector<FrameTiming>& timings) {
+  std::ifstream in(file);
+  std::string line;
+  // Header
+  if (!std::getline(in, line)) {
+    return false;
+  }
+  while (std::getline(in, line)) {
+    FrameTiming timing;
+    unsigned long long checksum;
+    if (std::sscanf(line.c_str(), "%d,%d,%lf,%llx", &timing.frame, &timing.key, &timing.milliseconds, &checksum) != 4) {
+      return false;
+    }
+    timing.checksum = checksum;
+    timings.push_back(timing);
+  }
+  return true;
+}
+
+bool compareTimings(const std::vector<FrameTiming>& run, const std::vector<FrameTiming>& baseline) {
+  if (run.size() != baseline.size()) {
+    print("Replay has", run.size(), "frames, baseline has", baseline.size());
+    return false;
+  }
+
+  bool sameImages = true;
+  double runTotal = 0;
+  double baselineTotal = 0;
+  for (size_t i = 0; i < run.size(); i++) {
+    runTotal += run[i].milliseconds;
+    baselineTotal += baseline[i].milliseconds;
+    double change = 100.0 * (run[i].milliseconds / baseline[i].milliseconds - 1.0);
+
+    char line[128];
+    std::snprintf(line, sizeof(line), "frame %d: %.1f ms, baseline %.1f ms (%+.1f%%)%s",
+                  run[i].frame, run[i].milliseconds, baseline[i].milliseconds, change,
+                  run[i].checksum == baseline[i].checksum ? "" : ", image differs");
+    print(line);
+    sameImages = sameImages && run[i].checksum == baseline[i].checksum;
+  }
+
+  char line[128];
+  std::snprintf(line, sizeof(line), "total: %.1f ms, baseline %.1f ms (%+.1f%%)",
+                runTotal, baselineTotal, 100.0 * (runTotal / baselineTotal - 1.0));
+  print(line);
+  return sameImages;
+}
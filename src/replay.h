@@ -0,0 +1,55 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <glm/glm.hpp>
+#include "camera.h"
+#include "framebuffer.h"
+#include "renderer.h"
+
+// One handled key press and the state it left the camera, light and
+// settings in. A recording starts with the initial state under key 0.
+struct InputEvent {
+  // Milliseconds since the recording started
+  uint32_t time;
+  SDL_Keycode key;
+  Camera camera;
+  glm::vec3 lightPosition;
+  RenderSettings settings;
+};
+
+// Appends events to a text log, one per line, with floats written exactly
+class InputRecorder {
+public:
+  explicit InputRecorder(const std::string& file);
+
+  bool isOpen() const { return out.is_open(); }
+  void record(const InputEvent& event);
+
+private:
+  std::ofstream out;
+};
+
+// Returns false if the log can't be read or a line is malformed
+bool loadRecording(const std::string& file, std::vector<InputEvent>& events);
+
+// FNV-1a hash of the frame's pixels, to tell whether two runs drew the same image
+uint64_t frameChecksum(const Framebuffer& frame);
+
+// Per-frame results of a replay, stored as CSV next to its frame dumps
+struct FrameTiming {
+  int frame;
+  SDL_Keycode key;
+  double milliseconds;
+  uint64_t checksum;
+};
+
+bool saveTimings(const std::vector<FrameTiming>& timings, const std::string& file);
+bool loadTimings(const std::string& file, std::vector<FrameTiming>& timings);
+
+// Prints the per-frame and total time of run against baseline. Returns false
+// if the runs don't cover the same frames or any frame drew a different image.
+bool compareTimings(const std::vector<FrameTiming>& run, const std::vector<FrameTiming>& baseline);
@@ -0,0 +1,173 @@
+#include "sampler.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <glm/gtc/constants.hpp>
+#include "bluenoise.h"
+
+namespace {
+
+const int SOBOL_DIMENSIONS = 4;
+const int SOBOL_BITS = 32;
+
+uint32_t hash(uint32_t x) {
+  x ^= x >> 16;
+  x *= 0x7feb352du;
+  x ^= x >> 15;
+  x *= 0x846ca68bu;
+  x ^= x >> 16;
+  return x;
+}
+
+uint32_t hashCombine(uint32_t seed, uint32_t value) {
+  return seed ^ (hash(value) + 0x9e3779b9u + (seed << 6) + (seed >> 2));
+}
+
+uint32_t reverseBits(uint32_t x) {
+  x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+  x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+  x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+  x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+  return (x >> 16) | (x << 16);
+}
+
+// Laine-Karras style hash that only lets bits affect more significant ones
+uint32_t laineKarrasPermutation(uint32_t x, uint32_t seed) {
+  x += seed;
+  x ^= x * 0x6c50b47cu;
+  x ^= x * 0xb82f1e52u;
+  x ^= x * 0xc7afe638u;
+  x ^= x * 0x8d22f6e6u;
+  return x;
+}
+
+// Owen scrambling of a 32 bit fixed point value
+uint32_t nestedUniformScramble(uint32_t x, uint32_t seed) {
+  return reverseBits(laineKarrasPermutation(reverseBits(x), seed));
+}
+
+// Direction numbers of the first four Sobol dimensions (Joe and Kuo)
+std::array<std::array<uint32_t, SOBOL_BITS>, SOBOL_DIMENSIONS> makeDirections() {
+  struct Polynomial { int degree; uint32_t coefficients; uint32_t initial[3]; };
+  const Polynomial polynomials[SOBOL_DIMENSIONS - 1] = {
+    {1, 0, {1}},
+    {2, 1, {1, 3}},
+    {3, 1, {1, 3, 1}},
+  };
+
+  std::array<std::array<uint32_t, SOBOL_BITS>, SOBOL_DIMENSIONS> directions{};
+  for (int bit = 0; bit < SOBOL_BITS; bit++) {
+    directions[0][bit] = 1u << (31 - bit);
+  }
+
+  for (int dimension = 1; dimension < SOBOL_DIMENSIONS; dimension++) {
+    const Polynomial& p = polynomials[dimension - 1];
+    auto& v = directions[dimension];
+    for (int bit = 0; bit < SOBOL_BITS; bit++) {
+      if (bit < p.degree) {
+        v[bit] = p.initial[bit] << (31 - bit);
+        continue;
+      }
+      v[bit] = v[bit - p.degree] ^ (v[bit - p.degree] >> p.degree);
+      for (int k = 1; k < p.degree; k++) {
+        if ((p.coefficients >> (p.degree - 1 - k)) & 1) {
+          v[bit] ^= v[bit - k];
+        }
+      }
+    }
+  }
+  return directions;
+}
+
+const auto SOBOL_DIRECTIONS = makeDirections();
+
+uint32_t sobol(uint32_t index, int dimension) {
+  uint32_t result = 0;
+  for (int bit = 0; index; bit++, index >>= 1) {
+    if (index & 1) {
+      result ^= SOBOL_DIRECTIONS[dimension][bit];
+    }
+  }
+  return result;
+}
+
+float owenScrambledSobol(uint32_t index, int dimension, uint32_t seed) {
+  // Every group of four dimensions is an independently shuffled 4D sequence
+  uint32_t groupSeed = hashCombine(seed, dimension / SOBOL_DIMENSIONS);
+  uint32_t shuffled = nestedUniformScramble(index, groupSeed);
+  uint32_t value = sobol(shuffled, dimension % SOBOL_DIMENSIONS);
+  value = nestedUniformScramble(value, hashCombine(groupSeed, dimension));
+  return (value >> 8) * (1.0f / 16777216.0f);
+}
+
+static_assert(SAMPLER_TILE_SIZE == 64, "bluenoise.h holds a 64x64 mask");
+
+// Precomputed, so no frame ever waits for the mask to be built
+float blueNoiseValue(int x, int y) {
+  int rank = BLUE_NOISE_RANKS[(y & (SAMPLER_TILE_SIZE - 1)) * SAMPLER_TILE_SIZE + (x & (SAMPLER_TILE_SIZE - 1))];
+  return (rank + 0.5f) / (SAMPLER_TILE_SIZE * SAMPLER_TILE_SIZE);
+}
+
+}
+
+Sampler::Sampler(uint32_t seed, int x, int y, bool blueNoise)
+  : x(x), y(y), blueNoise(blueNoise) {
+  uint32_t tile = tileSeed(seed, x / SAMPLER_TILE_SIZE, y / SAMPLER_TILE_SIZE);
+  // With blue noise every pixel walks the same sequence and only the rotation differs
+  pixelSeed = blueNoise ? tile : hashCombine(tile, (y % SAMPLER_TILE_SIZE) * SAMPLER_TILE_SIZE + x % SAMPLER_TILE_SIZE);
+}
+
+uint32_t Sampler::tileSeed(uint32_t seed, int tileX, int tileY) {
+  return hashCombine(hashCombine(hash(seed), tileX), tileY);
+}
+
+float Sampler::get1D(int sampleIndex, int dimension) const {
+  float value = owenScrambledSobol(sampleIndex, dimension, pixelSeed);
+  if (!blueNoise) {
+    return value;
+  }
+
+  // Cranley-Patterson rotation by the mask, shifted by an R2 step per dimension
+  // so the dimensions don't all see the same rotation
+  int shiftX = static_cast<int>(std::fmod(dimension * 0.7548776662f, 1.0f) * SAMPLER_TILE_SIZE);
+  int shiftY = static_cast<int>(std::fmod(dimension * 0.5698402910f, 1.0f) * SAMPLER_TILE_SIZE);
+  value += blueNoiseValue(x + shiftX, y + shiftY);
+  return value >= 1.0f ? value - 1.0f : value;
+}
+
+glm::vec2 Sampler::get2D(int sampleIndex, int dimension) const {
+  return glm::vec2(get1D(sampleIndex, dimension), get1D(sampleIndex, dimension + 1));
+}
+
+namespace {
+
+void orthonormalBasis(const glm::vec3& n, glm::vec3& t, glm::vec3& b) {
+  // Duff et al. 2017, branchless apart from the sign
+  float sign = std::copysign(1.0f, n.z);
+  float a = -1.0f / (sign + n.z);
+  float c = n.x * n.y * a;
+  t = glm::vec3(1.0f + sign * n.x * n.x * a, sign * c, -sign * n.x);
+  b = glm::vec3(c, sign + n.y * n.y * a, -n.y);
+}
+
+}
+
+glm::vec3 sampleCone(const glm::vec3& axis, float spread, const glm::vec2& u) {
+  float cosMax = std::cos(spread * glm::pi<float>() / 2.0f);
+  float cosTheta = 1.0f - u.x * (1.0f - cosMax);
+  float sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
+  float phi = 2.0f * glm::pi<float>() * u.y;
+
+  glm::vec3 t, b;
+  orthonormalBasis(axis, t, b);
+  return glm::normalize(t * (std::cos(phi) * sinTheta) + b * (std::sin(phi) * sinTheta) + axis * cosTheta);
+}
+
+glm::vec3 sampleDisk(const glm::vec3& center, const glm::vec3& normal, float radius, const glm::vec2& u) {
+  float r = radius * std::sqrt(u.x);
+  float phi = 2.0f * glm::pi<float>() * u.y;
+
+  glm::vec3 t, b;
+  orthonormalBasis(normal, t, b);
+  return center + t * (r * std::cos(phi)) + b * (r * std::sin(phi));
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstdint>
+#include <glm/glm.hpp>
+
+// Side of the tiles samplers are seeded by, and of the blue-noise mask
+const int SAMPLER_TILE_SIZE = 64;
+
+// Deterministic sample values for one pixel. Every value is a pure function of
+// (seed, pixel, sample index, dimension), so threads never share state and a
+// parallel render gives the same image bit for bit on every run.
+//
+// Sequences are 4D Sobol points with hash-based Owen scrambling (Burley 2020);
+// each group of four dimensions is padded with an independently shuffled copy.
+// Pixels are decorrelated either by a per-pixel scramble seed, or by rotating
+// one shared sequence with a blue-noise mask, which leaves the remaining error
+// as high-frequency noise that is easy to filter.
+class Sampler {
+public:
+  // Dimensions consumed per sample: pixel jitter, then per bounce a light sample and a glossy sample
+  static const int PIXEL_DIMENSION = 0;
+  static const int FIRST_BOUNCE_DIMENSION = 2;
+  static const int DIMENSIONS_PER_BOUNCE = 4;
+
+  Sampler(uint32_t seed, int x, int y, bool blueNoise);
+
+  // Seed shared by the pixels of one tile
+  static uint32_t tileSeed(uint32_t seed, int tileX, int tileY);
+
+  float get1D(int sampleIndex, int dimension) const;
+  glm::vec2 get2D(int sampleIndex, int dimension) const;
+
+private:
+  uint32_t pixelSeed;
+  int x;
+  int y;
+  bool blueNoise;
+};
+
+// Uniformly distributed direction in the cone of half angle (pi/2 * spread) around axis
+glm::vec3 sampleCone(const glm::vec3& axis, float spread, const glm::vec2& u);
+
+// Uniformly distributed point on a disk of the given radius facing along normal
+glm::vec3 sampleDisk(const glm::vec3& center, const glm::vec3& normal, float radius, const glm::vec2& u);
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <vector>
+#include "light.h"
+#include "object.h"
+#include "skybox.h"
+
+struct Scene {
+  std::vector<Object*> objects;
+  Light light;
+  const Skybox* skybox;
+};
@@ -0,0 +1,338 @@
+#include "server.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+#include <atomic>
+#include <cerrno>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+#include "bmp.h"
+#include "framebuffer.h"
+#include "print.h"
+
+namespace {
+
+const int MAX_IMAGE_SIZE = 4096;
+// Pixels of one image; every scene keeps its last frame and G-buffer resident,
+// about 80 bytes per pixel
+const long MAX_PIXELS = 1 << 21;
+// Traced samples of one image, which bounds how long a job holds the queue
+const long MAX_SAMPLE_BUDGET = 1 << 25;
+const int MAX_SAMPLES = 64;
+const size_t MAX_REQUEST_SIZE = 8192;
+
+// Threads reading requests and sending images, and accepted connections that may wait for one
+const int CONNECTION_THREADS = 8;
+const size_t MAX_PENDING_CONNECTIONS = 64;
+// A client that sends or reads nothing for this long is dropped
+const int SOCKET_TIMEOUT_SECONDS = 10;
+
+struct Response {
+  int status;
+  std::string contentType;
+  std::string body;
+};
+
+std::map<std::string, std::string> parseQuery(const std::string& query) {
+  std::map<std::string, std::string> params;
+  std::istringstream stream(query);
+  std::string pair;
+  while (std::getline(stream, pair, '&')) {
+    size_t equals = pair.find('=');
+    if (equals != std::string::npos) {
+      params[pair.substr(0, equals)] = pair.substr(equals + 1);
+    }
+  }
+  return params;
+}
+
+int intParam(const std::map<std::string, std::string>& params, const std::string& name, int fallback, int min, int max) {
+  auto found = params.find(name);
+  if (found == params.end()) {
+    return fallback;
+  }
+  char* end;
+  long value = std::strtol(found->second.c_str(), &end, 10);
+  if (*end != '\0' || value < min || value > max) {
+    throw std::invalid_argument(name + " must be an integer between " + std::to_string(min) + " and " + std::to_string(max));
+  }
+  return static_cast<int>(value);
+}
+
+glm::vec3 vecParam(const std::map<std::string, std::string>& params, const std::string& name, glm::vec3 fallback) {
+  auto found = params.find(name);
+  if (found == params.end()) {
+    return fallback;
+  }
+  glm::vec3 value;
+  if (std::sscanf(found->second.c_str(), "%f,%f,%f", &value.x, &value.y, &value.z) != 3 ||
+      !std::isfinite(value.x) || !std::isfinite(value.y) || !std::isfinite(value.z)) {
+    throw std::invalid_argument(name + " must be three comma separated numbers");
+  }
+  return value;
+}
+
+// A camera that can't be turned into a basis would trace NaN rays
+Camera cameraParams(const std::map<std::string, std::string>& params) {
+  glm::vec3 eye = vecParam(params, "eye", glm::vec3(0.0f, 0.0f, 5.0f));
+  glm::vec3 target = vecParam(params, "target", glm::vec3(0.0f));
+  glm::vec3 up = vecParam(params, "up", glm::vec3(0.0f, 1.0f, 0.0f));
+
+  glm::vec3 forward = target - eye;
+  if (glm::length(forward) < 1e-6f) {
+    throw std::invalid_argument("eye and target must differ");
+  }
+  if (glm::length(up) < 1e-6f || glm::length(glm::cross(glm::normalize(forward), glm::normalize(up))) < 1e-4f) {
+    throw std::invalid_argument("up must not be zero or parallel to the view direction");
+  }
+  return Camera(eye, target, up, 10.0f);
+}
+
+void sendResponse(int client, const Response& response) {
+  const char* reason =
+    response.status == 200 ? "OK" :
+    response.status == 404 ? "Not Found" :
+    response.status == 500 ? "Internal Server Error" :
+    response.status == 503 ? "Service Unavailable" : "Bad Request";
+  std::string head = "HTTP/1.0 " + std::to_string(response.status) + " " + reason + "\r\n"
+    "Content-Type: " + response.contentType + "\r\n"
+    "Content-Length: " + std::to_string(response.body.size()) + "\r\n"
+    "Connection: close\r\n\r\n";
+
+  std::string message = head + response.body;
+  size_t sent = 0;
+  while (sent < message.size()) {
+    // MSG_NOSIGNAL: a client hanging up must not kill the server with SIGPIPE
+    ssize_t written = send(client, message.data() + sent, message.size() - sent, MSG_NOSIGNAL);
+    if (written <= 0) {
+      return;
+    }
+    sent += written;
+  }
+}
+
+}
+
+RenderServer::RenderServer(const std::map<std::string, const Scene*>& scenes, ThreadPool& pool)
+  : scenes(scenes), pool(pool) {
+  for (const auto& [name, scene] : scenes) {
+    renderers[name] = std::make_unique<Renderer>(*scene, pool);
+  }
+  worker = std::thread(&RenderServer::workerLoop, this);
+}
+
+RenderServer::~RenderServer() {
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    stopping = true;
+  }
+  queueReady.notify_all();
+  worker.join();
+
+  // Connections still waiting for an image get an error instead
+  while (!jobs.empty()) {
+    const_cast<std::unique_ptr<Job>&>(jobs.top())->image.set_exception(
+      std::make_exception_ptr(std::runtime_error("server stopped")));
+    jobs.pop();
+  }
+
+  {
+    std::lock_guard<std::mutex> lock(clientMutex);
+    while (!pendingClients.empty()) {
+      close(pendingClients.front());
+      pendingClients.pop();
+    }
+  }
+  clientReady.notify_all();
+  for (std::thread& thread : connectionThreads) {
+    thread.join();
+  }
+}
+
+std::future<std::string> RenderServer::submit(std::unique_ptr<Job> job) {
+  std::future<std::string> image = job->image.get_future();
+  {
+    std::lock_guard<std::mutex> lock(queueMutex);
+    job->sequence = nextSequence++;
+    jobs.push(std::move(job));
+  }
+  queueReady.notify_one();
+  return image;
+}
+
+void RenderServer::workerLoop() {
+  // Jobs are never cancelled once started
+  const std::atomic<bool> neverCancel{false};
+
+  while (true) {
+    std::unique_ptr<Job> job;
+    {
+      std::unique_lock<std::mutex> lock(queueMutex);
+      queueReady.wait(lock, [this] { return stopping || !jobs.empty(); });
+      if (stopping) {
+        return;
+      }
+      // priority_queue::top is const; the job is moved out right before it is popped
+      job = std::move(const_cast<std::unique_ptr<Job>&>(jobs.top()));
+      jobs.pop();
+    }
+
+    try {
+      Framebuffer& frame = frames.try_emplace(job->scene, job->width, job->height).first->second;
+      if (frame.width != job->width || frame.height != job->height) {
+        frame = Framebuffer(job->width, job->height);
+      }
+      renderers.at(job->scene)->render(job->camera, job->settings, frame, neverCancel);
+      job->image.set_value(encodeBmp(frame));
+    } catch (...) {
+      // Most likely out of memory; the scene starts over with empty buffers
+      frames.erase(job->scene);
+      renderers[job->scene] = std::make_unique<Renderer>(*scenes.at(job->scene), pool);
+      job->image.set_exception(std::current_exception());
+    }
+  }
+}
+
+void RenderServer::connectionLoop() {
+  while (true) {
+    int client;
+    {
+      std::unique_lock<std::mutex> lock(clientMutex);
+      clientReady.wait(lock, [this] { return stopping || !pendingClients.empty(); });
+      if (stopping) {
+        return;
+      }
+      client = pendingClients.front();
+      pendingClients.pop();
+    }
+    handleConnection(client);
+  }
+}
+
+void RenderServer::handleConnection(int client) {
+  std::string request;
+  char chunk[1024];
+  while (request.find("\r\n\r\n") == std::string::npos && request.size() < MAX_REQUEST_SIZE) {
+    ssize_t received = recv(client, chunk, sizeof(chunk), 0);
+    if (received <= 0) {
+      break;
+    }
+    request.append(chunk, received);
+  }
+
+  Response response{404, "text/plain", "not found\n"};
+
+  std::istringstream requestLine(request.substr(0, request.find("\r\n")));
+  std::string method, target;
+  requestLine >> method >> target;
+
+  std::string path = target.substr(0, target.find('?'));
+  std::string query = target.find('?') == std::string::npos ? "" : target.substr(target.find('?') + 1);
+
+  if (method == "GET" && path == "/render") {
+    try {
+      auto params = parseQuery(query);
+      std::string scene = params.count("scene") ? params["scene"] : "pokeball";
+      if (!renderers.count(scene)) {
+        throw std::invalid_argument("unknown scene " + scene);
+      }
+
+      int width = intParam(params, "width", 320, 1, MAX_IMAGE_SIZE);
+      int height = intParam(params, "height", 240, 1, MAX_IMAGE_SIZE);
+      long pixels = long(width) * height;
+      if (pixels > MAX_PIXELS) {
+        throw std::invalid_argument("width * height must be at most " + std::to_string(MAX_PIXELS));
+      }
+
+      RenderSettings settings;
+      settings.samplesPerPixel = intParam(params, "samples", 1, 1, MAX_SAMPLES);
+      settings.denoise = intParam(params, "denoise", 0, 0, 1) == 1;
+      settings.seed = intParam(params, "seed", 0, 0, 1 << 30);
+      settings.indirect = intParam(params, "indirect", 0, 0, 1) == 1;
+      if (pixels * settings.samplesPerPixel > MAX_SAMPLE_BUDGET) {
+        throw std::invalid_argument("width * height * samples must be at most " + std::to_string(MAX_SAMPLE_BUDGET));
+      }
+
+      auto job = std::unique_ptr<Job>(new Job{
+        intParam(params, "priority", 0, -100, 100),
+        0,
+        scene,
+        cameraParams(params),
+        settings,
+        width,
+        height,
+        {}
+      });
+
+      response = Response{200, "image/bmp", submit(std::move(job)).get()};
+    } catch (const std::invalid_argument& error) {
+      response = Response{400, "text/plain", std::string(error.what()) + "\n"};
+    } catch (const std::exception& error) {
+      response = Response{500, "text/plain", "render failed: " + std::string(error.what()) + "\n"};
+    }
+  }
+
+  sendResponse(client, response);
+  close(client);
+}
+
+bool RenderServer::serve(int port) {
+  int listener = socket(AF_INET, SOCK_STREAM, 0);
+  if (listener < 0) {
+    print("Unable to open socket:", std::strerror(errno));
+    return false;
+  }
+
+  int reuse = 1;
+  setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+
+  // Local connections only; this is a backend for services on the same machine
+  sockaddr_in address{};
+  address.sin_family = AF_INET;
+  address.sin_port = htons(port);
+  address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+  if (bind(listener, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || listen(listener, 64) < 0) {
+    print("Unable to listen on port", port, std::strerror(errno));
+    close(listener);
+    return false;
+  }
+
+  print("Render server listening on 127.0.0.1:" + std::to_string(port));
+
+  // Connections only parse and wait; the rendering itself is serialized by the queue
+  for (int i = 0; i < CONNECTION_THREADS; i++) {
+    connectionThreads.emplace_back(&RenderServer::connectionLoop, this);
+  }
+
+  while (true) {
+    int client = accept(listener, nullptr, nullptr);
+    if (client < 0) {
+      continue;
+    }
+    timeval timeout{SOCKET_TIMEOUT_SECONDS, 0};
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+    setsockopt(client, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    {
+      std::lock_guard<std::mutex> lock(clientMutex);
+      if (pendingClients.size() < MAX_PENDING_CONNECTIONS) {
+        pendingClients.push(client);
+        client = -1;
+      }
+    }
+    if (client < 0) {
+      clientReady.notify_one();
+    } else {
+      sendResponse(client, Response{503, "text/plain", "too many connections\n"});
+      close(client);
+    }
+  }
+}
@@ -0,0 +1,79 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <future>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <string>
+#include <vector>
+#include "camera.h"
+#include "renderer.h"
+#include "scene.h"
+#include "threadpool.h"
+
+// Long-running render service. Scenes, their renderers and every buffer they
+// own stay resident between jobs, so a request only pays for tracing.
+//
+//   GET /render?scene=pokeball&width=320&height=240&samples=1
+//              &eye=0,0,5&target=0,0,0&up=0,1,0&priority=0
+//
+// answers with an image/bmp. Jobs wait in a priority queue, higher priority
+// first and in arrival order within a priority, and run one at a time on the
+// shared thread pool. Connections are served by a fixed set of threads; when
+// too many are waiting, new ones are turned away with a 503.
+class RenderServer {
+public:
+  RenderServer(const std::map<std::string, const Scene*>& scenes, ThreadPool& pool);
+  ~RenderServer();
+
+  // Listens on 127.0.0.1:port and never returns unless the socket can't be opened
+  bool serve(int port);
+
+private:
+  struct Job {
+    int priority;
+    uint64_t sequence;
+    std::string scene;
+    Camera camera;
+    RenderSettings settings;
+    int width;
+    int height;
+    std::promise<std::string> image;
+  };
+
+  struct JobOrder {
+    bool operator()(const std::unique_ptr<Job>& a, const std::unique_ptr<Job>& b) const {
+      if (a->priority != b->priority) {
+        return a->priority < b->priority;
+      }
+      return a->sequence > b->sequence;
+    }
+  };
+
+  std::map<std::string, const Scene*> scenes;
+  ThreadPool& pool;
+  std::map<std::string, std::unique_ptr<Renderer>> renderers;
+  // Last image of each scene; a repeated request leaves it as it is
+  std::map<std::string, Framebuffer> frames;
+
+  std::mutex queueMutex;
+  std::condition_variable queueReady;
+  std::priority_queue<std::unique_ptr<Job>, std::vector<std::unique_ptr<Job>>, JobOrder> jobs;
+  uint64_t nextSequence = 0;
+  bool stopping = false;
+  std::thread worker;
+
+  // Accepted sockets waiting for a connection thread
+  std::mutex clientMutex;
+  std::condition_variable clientReady;
+  std::queue<int> pendingClients;
+  std::vector<std::thread> connectionThreads;
+
+  void workerLoop();
+  void connectionLoop();
+  void handleConnection(int client);
+  std::future<std::string> submit(std::unique_ptr<Job> job);
+};
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include "material.h"
+
+// Feature bits of a material. Objects are classified once when the scene is
+// built so each hit can go straight to a kernel with the unused terms compiled out.
+namespace MaterialFeature {
+  constexpr uint8_t DIFFUSE_ONLY = 0;
+  constexpr uint8_t SPECULAR = 1 << 0;
+  constexpr uint8_t MIRROR = 1 << 1;
+  constexpr uint8_t GLASS = 1 << 2;
+  constexpr uint8_t TEXTURED = 1 << 3;
+}
+
+// One kernel per combination of feature bits
+const int SHADING_KERNEL_COUNT = 16;
+
+inline uint8_t classifyMaterial(const Material& mat) {
+  uint8_t features = MaterialFeature::DIFFUSE_ONLY;
+  if (mat.specularAlbedo > 0) {
+    features |= MaterialFeature::SPECULAR;
+  }
+  if (mat.reflectivity > 0) {
+    features |= MaterialFeature::MIRROR;
+  }
+  if (mat.transparency > 0) {
+    features |= MaterialFeature::GLASS;
+  }
+  if (mat.diffuseMap || mat.specularMap || mat.normalMap) {
+    features |= MaterialFeature::TEXTURED;
+  }
+  return features;
+}
@@ -1,26 +1,34 @@
 #include "skybox.h"
-#include "SDL_image.h"
-#include <iostream>
+#include <utility>
+#include <glm/gtc/constants.hpp>
 
-Skybox::Skybox(const std::string& textureFile) {
-    texture = nullptr;
-    loadTexture(textureFile);
-}
+Skybox::Skybox(const std::string& textureFile) : textureFile(textureFile) {}
 
 Skybox::~Skybox() {
-    SDL_FreeSurface(texture);
+    waitUntilLoaded();
+}
+
+void Skybox::loadAsync(std::function<void()> onLoaded) {
+    loading = std::async(std::launch::async, [this, onLoaded = std::move(onLoaded)] {
+        if (!loadImage(textureFile, texture)) {
+            return;
+        }
+        loaded.store(true, std::memory_order_release);
+        if (onLoaded) {
+            onLoaded();
+        }
+    });
 }
 
-void Skybox::loadTexture(const std::string& textureFile) {
-    texture = IMG_Load(textureFile.c_str());
-    if (!texture) {
-        throw std::runtime_error("Failed to load skybox texture: " + std::string(IMG_GetError()));
+void Skybox::waitUntilLoaded() const {
+    if (loading.valid()) {
+        loading.wait();
     }
 }
 
 glm::vec3 Skybox::getColor(const glm::vec3& direction) const {
 
-    if (!texture) {
+    if (!isLoaded()) {
         return glm::vec3(0.5f, 0.7f, 1.0f); // Default color if texture is not loaded
     }
 
@@ -35,25 +43,23 @@ glm::vec3 Skybox::getColor(const glm::vec3& direction) const {
     theta -= 0.5f;
 
     // Map spherical coordinates to UV coordinates
-    const float pi = 3.14159265358979323846f;
-    float u = 0.5f + phi / (2.0f * pi);
-    float v = 0.5f - theta / pi;
+    float u = 0.5f + phi / (2.0f * glm::pi<float>());
+    float v = 0.5f - theta / glm::pi<float>();
 
     // Sample the texture
-    int texX = static_cast<int>(u * texture->w);
-    int texY = static_cast<int>(v * texture->h);
+    int texX = static_cast<int>(u * texture.width);
+    int texY = static_cast<int>(v * texture.height);
 
     // Ensure coordinates are within bounds
-    texX = glm::clamp(texX, 0, texture->w - 1);
-    texY = glm::clamp(texY, 0, texture->h - 1);
+    texX = glm::clamp(texX, 0, texture.width - 1);
+    texY = glm::clamp(texY, 0, texture.height - 1);
 
     // Get the color from the texture
-    Uint8* pixels = static_cast<Uint8*>(texture->pixels);
-    Uint8* pixel = pixels + texY * texture->pitch + texX * texture->format->BytesPerPixel;
+    const Color& pixel = texture.pixels[texY * texture.width + texX];
 
-    float colorR = pixel[0] / 255.0f;
-    float colorG = pixel[1] / 255.0f;
-    float colorB = pixel[2] / 255.0f;
+    float colorR = pixel.r / 255.0f;
+    float colorG = pixel.g / 255.0f;
+    float colorB = pixel.b / 255.0f;
 
     return glm::vec3(colorR, colorG, colorB);
 }
\ No newline at end of file
@@ -1,17 +1,31 @@
 #pragma once
+#include <atomic>
+#include <functional>
+#include <future>
 #include <string>
-#include <SDL.h>
 #include <glm/glm.hpp>
+#include "image.h"
 
 class Skybox {
 public:
     Skybox(const std::string& textureFile);
     ~Skybox();
 
+    // Decodes the texture on a background thread. Until it is done getColor
+    // returns a flat placeholder sky; onLoaded runs on that thread once the
+    // real texture is in use. Whatever onLoaded touches must outlive the load,
+    // call waitUntilLoaded before destroying it.
+    void loadAsync(std::function<void()> onLoaded = nullptr);
+    // Blocks until loadAsync has finished, successfully or not
+    void waitUntilLoaded() const;
+    bool isLoaded() const { return loaded.load(std::memory_order_acquire); }
+
     glm::vec3 getColor(const glm::vec3& direction) const;
 
 private:
-    SDL_Surface* texture;
-
-    void loadTexture(const std::string& textureFile);
-};
\ No newline at end of file
+    std::string textureFile;
+    Image texture;
+    // Set once texture is complete, readers only touch it after seeing this
+    std::atomic<bool> loaded{false};
+    std::future<void> loading;
+};
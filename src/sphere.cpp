@@ -1,8 +1,18 @@
 #include "sphere.h"
+#include <glm/gtc/constants.hpp>
 
 Sphere::Sphere(const glm::vec3& center, float radius, const Material& mat)
   : center(center), radius(radius), Object(mat) {}
 
+Bounds Sphere::bounds() const {
+  return Bounds{center - glm::vec3(radius), center + glm::vec3(radius)};
+}
+
+void Sphere::setCenter(const glm::vec3& newCenter) {
+  center = newCenter;
+  markChanged();
+}
+
 Intersect Sphere::rayIntersect(const glm::vec3& rayOrigin, const glm::vec3& rayDirection) const {
   glm::vec3 oc = rayOrigin - center;
 
@@ -24,7 +34,14 @@ Intersect Sphere::rayIntersect(const glm::vec3& rayOrigin, const glm::vec3& rayD
 
   glm::vec3 point = rayOrigin + dist * rayDirection;
   glm::vec3 normal = glm::normalize(point - center);
-  return Intersect{true, dist, point, normal};
+
+  // Latitude/longitude mapping, u around the y axis and v from pole to pole
+  glm::vec2 uv(0.5f + atan2(normal.z, normal.x) / (2.0f * glm::pi<float>()), 0.5f - asin(normal.y) / glm::pi<float>());
+  glm::vec3 tangent = glm::length(glm::vec3(normal.x, 0.0f, normal.z)) > 0.0f
+    ? glm::normalize(glm::vec3(-normal.z, 0.0f, normal.x))
+    : glm::vec3(1.0f, 0.0f, 0.0f);
+
+  return Intersect{true, dist, point, normal, uv, tangent, 1.0f / (2.0f * glm::pi<float>() * radius)};
 }
 
 
@@ -10,6 +10,11 @@ public:
   Sphere(const glm::vec3& center, float radius, const Material& mat);
 
   Intersect rayIntersect(const glm::vec3& rayOrigin, const glm::vec3& rayDirection) const override;
+  Bounds bounds() const override;
+
+  const glm::vec3& getCenter() const { return center; }
+  float getRadius() const { return radius; }
+  void setCenter(const glm::vec3& newCenter);
 
 private:
   glm::vec3 center;
@@ -0,0 +1,263 @@
+#include "texture.h"
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "image.h"
+
+namespace {
+
+uint64_t tileKey(uint16_t texture, int level, int tileX, int tileY) {
+  return (uint64_t(texture) << 48) | (uint64_t(level) << 40) | (uint64_t(tileX) << 20) | uint64_t(tileY);
+}
+
+// Tiles each thread used last. A hit reads the tile without the shared cache's
+// lock, LRU update or reference count; it also doesn't refresh the tile in the
+// LRU, and a handle keeps its tile alive after eviction until it is replaced.
+const int TILE_HANDLES = 16;
+
+struct TileHandle {
+  const TextureCache* cache = nullptr;
+  uint64_t key = 0;
+  std::shared_ptr<const TextureTile> tile;
+};
+
+thread_local std::array<TileHandle, TILE_HANDLES> tileHandles;
+
+int wrap(int value, int size) {
+  int wrapped = value % size;
+  return wrapped < 0 ? wrapped + size : wrapped;
+}
+
+Color lerp(const Color& a, const Color& b, float t) {
+  return Color(
+    static_cast<int>(a.r + (b.r - a.r) * t + 0.5f),
+    static_cast<int>(a.g + (b.g - a.g) * t + 0.5f),
+    static_cast<int>(a.b + (b.b - a.b) * t + 0.5f),
+    static_cast<int>(a.a + (b.a - a.a) * t + 0.5f)
+  );
+}
+
+// Average of a 2x2 block, one texel of the next mip level
+Color box(const Color& c00, const Color& c10, const Color& c01, const Color& c11) {
+  return Color(
+    (c00.r + c10.r + c01.r + c11.r + 2) / 4,
+    (c00.g + c10.g + c01.g + c11.g + 2) / 4,
+    (c00.b + c10.b + c01.b + c11.b + 2) / 4,
+    (c00.a + c10.a + c01.a + c11.a + 2) / 4
+  );
+}
+
+}
+
+TextureCache::TextureCache(size_t capacityInTiles)
+  : shardCapacity(std::max<size_t>(1, capacityInTiles / SHARD_COUNT)) {}
+
+TextureCache::Shard& TextureCache::shardFor(uint64_t key) {
+  // Neighbouring tiles land in different shards
+  return shards[(key ^ (key >> 20) ^ (key >> 40)) % SHARD_COUNT];
+}
+
+uint16_t TextureCache::registerTexture() {
+  std::lock_guard<std::mutex> lock(idMutex);
+  return nextTextureId++;
+}
+
+std::shared_ptr<const TextureTile> TextureCache::find(uint64_t key) {
+  Shard& shard = shardFor(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+
+  auto found = shard.index.find(key);
+  if (found == shard.index.end()) {
+    return nullptr;
+  }
+  shard.entries.splice(shard.entries.begin(), shard.entries, found->second);
+  return found->second->tile;
+}
+
+std::shared_ptr<const TextureTile> TextureCache::insert(uint64_t key, std::shared_ptr<const TextureTile> tile) {
+  Shard& shard = shardFor(key);
+  std::lock_guard<std::mutex> lock(shard.mutex);
+
+  auto found = shard.index.find(key);
+  if (found != shard.index.end()) {
+    return found->second->tile;
+  }
+
+  shard.entries.push_front(Entry{key, std::move(tile)});
+  shard.index[key] = shard.entries.begin();
+
+  while (shard.entries.size() > shardCapacity) {
+    shard.index.erase(shard.entries.back().key);
+    shard.entries.pop_back();
+  }
+  return shard.entries.front().tile;
+}
+
+Texture::Texture(std::unique_ptr<ImageFile> source, TextureCache& cache)
+  : width(source->getWidth()), height(source->getHeight()), id(cache.registerTexture()),
+    source(std::move(source)), cache(&cache) {
+  levelCount = 1;
+  while ((width >> levelCount) > 0 || (height >> levelCount) > 0) {
+    levelCount++;
+  }
+  firstTailLevel = 0;
+  while (std::max(levelWidth(firstTailLevel), levelHeight(firstTailLevel)) > MIP_TAIL_SIZE) {
+    firstTailLevel++;
+  }
+
+  // The first tail level is read from its tiles, which builds the levels
+  // above it through the cache, so the source is never in memory at once
+  int w = levelWidth(firstTailLevel);
+  int h = levelHeight(firstTailLevel);
+  std::vector<Color> level(w * h);
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      auto found = tile(firstTailLevel, x / TILE_SIZE, y / TILE_SIZE);
+      level[y * w + x] = (*found)[(y % TILE_SIZE) * TILE_SIZE + (x % TILE_SIZE)];
+    }
+  }
+
+  for (int l = firstTailLevel; l < levelCount; l++) {
+    w = levelWidth(l);
+    h = levelHeight(l);
+    mipTail.push_back(level);
+    if (l + 1 == levelCount) {
+      break;
+    }
+
+    int nextWidth = levelWidth(l + 1);
+    int nextHeight = levelHeight(l + 1);
+    std::vector<Color> next(nextWidth * nextHeight);
+    for (int y = 0; y < nextHeight; y++) {
+      for (int x = 0; x < nextWidth; x++) {
+        int x0 = std::min(x * 2, w - 1);
+        int y0 = std::min(y * 2, h - 1);
+        int x1 = std::min(x0 + 1, w - 1);
+        int y1 = std::min(y0 + 1, h - 1);
+        next[y * nextWidth + x] = box(level[y0 * w + x0], level[y0 * w + x1], level[y1 * w + x0], level[y1 * w + x1]);
+      }
+    }
+    level = std::move(next);
+  }
+}
+
+Texture Texture::fromFile(const std::string& file, TextureCache& cache) {
+  auto source = std::make_unique<ImageFile>();
+  if (!source->open(file)) {
+    throw std::runtime_error("Failed to load texture: " + file);
+  }
+  return Texture(std::move(source), cache);
+}
+
+int Texture::levelWidth(int level) const {
+  return std::max(1, width >> level);
+}
+
+int Texture::levelHeight(int level) const {
+  return std::max(1, height >> level);
+}
+
+std::shared_ptr<const TextureTile> Texture::tile(int level, int tileX, int tileY) const {
+  uint64_t key = tileKey(id, level, tileX, tileY);
+  if (auto cached = cache->find(key)) {
+    return cached;
+  }
+  // Built without holding any lock; if two threads race the first insert wins
+  return cache->insert(key, buildTile(level, tileX, tileY));
+}
+
+std::shared_ptr<const TextureTile> Texture::buildTile(int level, int tileX, int tileY) const {
+  auto built = std::make_shared<TextureTile>();
+  int w = levelWidth(level);
+  int h = levelHeight(level);
+
+  if (level == 0) {
+    // Paged in row by row; texels past the edge of the image repeat the last one.
+    // A failed read leaves texels black rather than stopping the frame.
+    int firstX = tileX * TILE_SIZE;
+    int count = std::min(TILE_SIZE, w - firstX);
+    for (int y = 0; y < TILE_SIZE; y++) {
+      Color* row = built->data() + y * TILE_SIZE;
+      source->readRow(firstX, std::min(tileY * TILE_SIZE + y, h - 1), count, row);
+      std::fill(row + count, row + TILE_SIZE, row[count - 1]);
+    }
+    return built;
+  }
+
+  // A tile covers at most 2x2 tiles of the level below; each is fetched once
+  // and held here, so eviction can't make the build fetch it again
+  std::shared_ptr<const TextureTile> parents[2][2];
+  int parentWidth = level > 0 ? levelWidth(level - 1) : 0;
+  int parentHeight = level > 0 ? levelHeight(level - 1) : 0;
+
+  auto parentTexel = [&](int x, int y) {
+    int px = x / TILE_SIZE - tileX * 2;
+    int py = y / TILE_SIZE - tileY * 2;
+    auto& parent = parents[py][px];
+    if (!parent) {
+      parent = tile(level - 1, x / TILE_SIZE, y / TILE_SIZE);
+    }
+    return (*parent)[(y % TILE_SIZE) * TILE_SIZE + (x % TILE_SIZE)];
+  };
+
+  for (int y = 0; y < TILE_SIZE; y++) {
+    for (int x = 0; x < TILE_SIZE; x++) {
+      // Texels past the edge of small levels repeat the last one
+      int levelX = std::min(tileX * TILE_SIZE + x, w - 1);
+      int levelY = std::min(tileY * TILE_SIZE + y, h - 1);
+      Color& out = (*built)[y * TILE_SIZE + x];
+
+      // Box filter of the 2x2 texels below
+      int x0 = std::min(levelX * 2, parentWidth - 1);
+      int y0 = std::min(levelY * 2, parentHeight - 1);
+      int x1 = std::min(x0 + 1, parentWidth - 1);
+      int y1 = std::min(y0 + 1, parentHeight - 1);
+      out = box(parentTexel(x0, y0), parentTexel(x1, y0), parentTexel(x0, y1), parentTexel(x1, y1));
+    }
+  }
+  return built;
+}
+
+const TextureTile& Texture::cachedTile(int level, int tileX, int tileY) const {
+  uint64_t key = tileKey(id, level, tileX, tileY);
+  // Neighbouring tiles and the same tile on adjacent levels use different handles
+  TileHandle& handle = tileHandles[(key ^ (key >> 19) ^ (key >> 40)) % TILE_HANDLES];
+  if (handle.cache != cache || handle.key != key || !handle.tile) {
+    handle.tile = tile(level, tileX, tileY);
+    handle.cache = cache;
+    handle.key = key;
+  }
+  return *handle.tile;
+}
+
+Color Texture::texel(int level, int x, int y) const {
+  if (level >= firstTailLevel) {
+    return mipTail[level - firstTailLevel][y * levelWidth(level) + x];
+  }
+  return cachedTile(level, x / TILE_SIZE, y / TILE_SIZE)[(y % TILE_SIZE) * TILE_SIZE + (x % TILE_SIZE)];
+}
+
+Color Texture::sample(const glm::vec2& uv, float footprint) const {
+  // A footprint of one texel at full resolution maps to level 0
+  float texelsCovered = footprint * std::max(width, height);
+  int level = texelsCovered > 1.0f ? static_cast<int>(std::log2(texelsCovered)) : 0;
+  level = std::min(level, levelCount - 1);
+
+  int w = levelWidth(level);
+  int h = levelHeight(level);
+  float x = (uv.x - std::floor(uv.x)) * w - 0.5f;
+  float y = (uv.y - std::floor(uv.y)) * h - 0.5f;
+  int x0 = static_cast<int>(std::floor(x));
+  int y0 = static_cast<int>(std::floor(y));
+  float fx = x - x0;
+  float fy = y - y0;
+
+  int wx0 = wrap(x0, w);
+  int wy0 = wrap(y0, h);
+  int wx1 = wrap(x0 + 1, w);
+  int wy1 = wrap(y0 + 1, h);
+
+  Color top = lerp(texel(level, wx0, wy0), texel(level, wx1, wy0), fx);
+  Color bottom = lerp(texel(level, wx0, wy1), texel(level, wx1, wy1), fx);
+  return lerp(top, bottom, fy);
+}
@@ -0,0 +1,100 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <glm/glm.hpp>
+#include "color.h"
+#include "image.h"
+
+// Texels are stored in square tiles so a bilinear lookup usually touches a
+// single 256 byte block instead of two rows that are a whole image apart
+const int TILE_SIZE = 8;
+
+// Mip levels this small are kept resident with the texture instead of in the
+// cache; they are hit by every distant lookup and are costly to rebuild
+const int MIP_TAIL_SIZE = 32;
+
+using TextureTile = std::array<Color, TILE_SIZE * TILE_SIZE>;
+
+// Fixed-size LRU cache of texture tiles shared by every texture and thread.
+// Full resolution tiles are paged in from disk and mip levels are built tile
+// by tile on demand, so memory stays bounded no matter how many or how large
+// the textures are. Tiles are handed out as shared pointers, so evicting one
+// never invalidates a lookup in progress.
+class TextureCache {
+public:
+  explicit TextureCache(size_t capacityInTiles);
+
+  std::shared_ptr<const TextureTile> find(uint64_t key);
+  // Returns the tile stored under key, which is the given one unless another thread was first
+  std::shared_ptr<const TextureTile> insert(uint64_t key, std::shared_ptr<const TextureTile> tile);
+
+  uint16_t registerTexture();
+
+private:
+  // Split into shards with their own lock and LRU list so threads rarely contend
+  static const int SHARD_COUNT = 16;
+
+  struct Entry {
+    uint64_t key;
+    std::shared_ptr<const TextureTile> tile;
+  };
+
+  struct Shard {
+    std::mutex mutex;
+    std::list<Entry> entries;  // most recently used first
+    std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+  };
+
+  size_t shardCapacity;
+  std::array<Shard, SHARD_COUNT> shards;
+  std::mutex idMutex;
+  uint16_t nextTextureId = 0;
+
+  Shard& shardFor(uint64_t key);
+};
+
+class Texture {
+public:
+  Texture(std::unique_ptr<ImageFile> source, TextureCache& cache);
+
+  // Opens an image file through its decoded cache on disk, see ImageFile.
+  // Throws std::runtime_error if it can't be read.
+  static Texture fromFile(const std::string& file, TextureCache& cache);
+
+  // Bilinear lookup with wrapping. footprint is the size of the area the
+  // lookup covers in uv units; it picks the mip level so distant hits read
+  // small, already filtered levels instead of full resolution texels.
+  Color sample(const glm::vec2& uv, float footprint) const;
+
+  int getWidth() const { return width; }
+  int getHeight() const { return height; }
+  int getLevelCount() const { return levelCount; }
+
+private:
+  int width;
+  int height;
+  int levelCount;
+  uint16_t id;
+  // Full resolution source on disk; the tiled mip chain lives in the cache
+  std::unique_ptr<ImageFile> source;
+  TextureCache* cache;
+  // Row major levels from firstTailLevel down to 1x1
+  int firstTailLevel;
+  std::vector<std::vector<Color>> mipTail;
+
+  int levelWidth(int level) const;
+  int levelHeight(int level) const;
+
+  std::shared_ptr<const TextureTile> tile(int level, int tileX, int tileY) const;
+  std::shared_ptr<const TextureTile> buildTile(int level, int tileX, int tileY) const;
+  // Tile through this thread's handles; valid until the thread's next lookup
+  const TextureTile& cachedTile(int level, int tileX, int tileY) const;
+  Color texel(int level, int x, int y) const;
+};
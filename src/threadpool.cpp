@@ -0,0 +1,74 @@
+#include "threadpool.h"
+
+ThreadPool::ThreadPool(unsigned threadCount) {
+  // The calling thread takes part in every job, so it counts as one of them
+  unsigned extraWorkers = threadCount > 1 ? threadCount - 1 : 0;
+  for (unsigned i = 0; i < extraWorkers; i++) {
+    workers.emplace_back(&ThreadPool::workerLoop, this);
+  }
+}
+
+ThreadPool::~ThreadPool() {
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    stopping = true;
+  }
+  wake.notify_all();
+  for (auto& worker : workers) {
+    worker.join();
+  }
+}
+
+unsigned ThreadPool::size() const {
+  return workers.size() + 1;
+}
+
+void ThreadPool::parallelFor(int count, const std::function<void(int)>& job) {
+  // Jobs from different callers run one after the other
+  std::lock_guard<std::mutex> submit(submitMutex);
+
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    task = &job;
+    taskCount = count;
+    nextIndex = 0;
+    busyWorkers = workers.size();
+    jobId++;
+  }
+  wake.notify_all();
+
+  runTasks(job, count);
+
+  std::unique_lock<std::mutex> lock(mutex);
+  done.wait(lock, [this] { return busyWorkers == 0; });
+  task = nullptr;
+}
+
+void ThreadPool::workerLoop() {
+  uint64_t lastJob = 0;
+  std::unique_lock<std::mutex> lock(mutex);
+
+  while (true) {
+    wake.wait(lock, [&] { return stopping || jobId != lastJob; });
+    if (stopping) {
+      return;
+    }
+    lastJob = jobId;
+    const std::function<void(int)>* job = task;
+    int count = taskCount;
+
+    lock.unlock();
+    runTasks(*job, count);
+    lock.lock();
+
+    if (--busyWorkers == 0) {
+      done.notify_one();
+    }
+  }
+}
+
+void ThreadPool::runTasks(const std::function<void(int)>& job, int count) {
+  for (int i = nextIndex.fetch_add(1); i < count; i = nextIndex.fetch_add(1)) {
+    job(i);
+  }
+}
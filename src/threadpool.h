@@ -0,0 +1,43 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Image rows handed to a worker at a time by row-parallel passes
+const int ROWS_PER_TASK = 8;
+
+// Fixed set of worker threads that split indexed jobs between them.
+// The thread calling parallelFor also works on the job until it is done.
+class ThreadPool {
+public:
+  explicit ThreadPool(unsigned threadCount = std::thread::hardware_concurrency());
+  ~ThreadPool();
+
+  // Calls task(i) for every i in [0, count) and returns once all of them finished
+  void parallelFor(int count, const std::function<void(int)>& task);
+
+  unsigned size() const;
+
+private:
+  std::vector<std::thread> workers;
+
+  std::mutex submitMutex;
+  std::mutex mutex;
+  std::condition_variable wake;
+  std::condition_variable done;
+
+  const std::function<void(int)>* task = nullptr;
+  int taskCount = 0;
+  std::atomic<int> nextIndex{0};
+  unsigned busyWorkers = 0;
+  uint64_t jobId = 0;
+  bool stopping = false;
+
+  void workerLoop();
+  void runTasks(const std::function<void(int)>& task, int count);
+};